@@ -0,0 +1,89 @@
+#include "BenchmarkData.h"
+#include "config.h"
+
+#include "../core/NetworkGenerator.h"
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <random>
+#include <tuple>
+
+std::string benchmarkDataFile(const std::string& filename)
+{
+	return BENCHMARK_DATA_PATH("") + filename;
+}
+
+Matrix<std::string> generateNumericObservations(unsigned int variables,
+                                                unsigned int samples,
+                                                float naRate)
+{
+	std::mt19937 generator(42);
+	std::normal_distribution<float> value(5.0f, 2.0f);
+	std::bernoulli_distribution isNA(naRate);
+
+	std::vector<std::string> rowNames;
+	rowNames.reserve(variables);
+	for(unsigned int row = 0; row < variables; row++) {
+		rowNames.push_back("V" + std::to_string(row));
+	}
+	std::vector<std::string> colNames(samples);
+	Matrix<std::string> observations(colNames, rowNames, "NA");
+	for(unsigned int row = 0; row < variables; row++) {
+		for(unsigned int col = 0; col < samples; col++) {
+			if(!isNA(generator)) {
+				observations(col, row) = std::to_string(value(generator));
+			}
+		}
+	}
+	return observations;
+}
+
+namespace {
+using NetworkKey = std::tuple<unsigned int, unsigned int, unsigned int, float>;
+
+GeneratedNetwork writeNetwork(unsigned int nodes, unsigned int maxParents,
+                              unsigned int samples, float naRate)
+{
+	const auto directory =
+	    std::filesystem::temp_directory_path() / "causaltrail-benchmarks";
+	std::filesystem::create_directories(directory);
+	const std::string prefix =
+	    (directory / ("network_" + std::to_string(nodes) + "_" +
+	                  std::to_string(maxParents) + "_" +
+	                  std::to_string(samples) + "_" +
+	                  std::to_string(static_cast<int>(naRate * 100))))
+	        .string();
+
+	GeneratorSettings settings;
+	settings.nodes = nodes;
+	settings.maxParents = maxParents;
+	settings.treewidth = 10;
+	NetworkGenerator generator(settings);
+
+	GeneratedNetwork result;
+	result.networkFile = prefix + ".tgf";
+	result.dataFile = prefix + ".txt";
+	result.controlFile = prefix + ".json";
+	for(const auto& node : generator.getNetwork().getNodes()) {
+		result.nodeNames.push_back(node.getName());
+	}
+	generator.writeNetwork(result.networkFile);
+	generator.writeObservations(result.dataFile, samples, naRate);
+	generator.writeDiscretisation(result.controlFile);
+	return result;
+}
+}
+
+const GeneratedNetwork& generateNetwork(unsigned int nodes,
+                                        unsigned int maxParents,
+                                        unsigned int samples, float naRate)
+{
+	static std::map<NetworkKey, std::unique_ptr<GeneratedNetwork>> cache;
+	auto& entry = cache[NetworkKey(nodes, maxParents, samples, naRate)];
+	if(!entry) {
+		entry = std::make_unique<GeneratedNetwork>(
+		    writeNetwork(nodes, maxParents, samples, naRate));
+	}
+	return *entry;
+}
@@ -0,0 +1,64 @@
+#ifndef BENCHMARKDATA_H
+#define BENCHMARKDATA_H
+
+#include "../core/Matrix.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * Files describing a randomly generated network together with samples drawn
+ * from it.
+ */
+struct GeneratedNetwork
+{
+	// TGF file containing the structure
+	std::string networkFile;
+	// Observations, one row per node and one column per sample
+	std::string dataFile;
+	// Discretisation control file, using the method "None" for all nodes
+	std::string controlFile;
+	// Names of the nodes in topological order
+	std::vector<std::string> nodeNames;
+};
+
+/**benchmarkDataFile
+ *
+ * @param filename, name of a file bundled with the test data
+ *
+ * @return the path of the file
+ */
+std::string benchmarkDataFile(const std::string& filename);
+
+/**generateNumericObservations
+ *
+ * @param variables, number of variables, i.e. rows
+ * @param samples, number of samples, i.e. columns
+ * @param naRate, fraction of the entries that are NA
+ *
+ * @return a matrix of normally distributed values in their string representation
+ */
+Matrix<std::string> generateNumericObservations(unsigned int variables,
+                                                unsigned int samples,
+                                                float naRate = 0.05f);
+
+/**generateNetwork
+ *
+ * @param nodes, number of nodes
+ * @param maxParents, maximal number of parents per node
+ * @param samples, number of samples drawn from the network
+ * @param naRate, fraction of the observations that are NA
+ *
+ * @return the files of the generated network
+ *
+ * The network is created by a NetworkGenerator, using a treewidth bound of
+ * 10, and written to the temporary directory. Networks are generated once per set of
+ * parameters and reused afterwards. The random seed is fixed, hence all runs
+ * work on the same data.
+ */
+const GeneratedNetwork& generateNetwork(unsigned int nodes,
+                                        unsigned int maxParents,
+                                        unsigned int samples,
+                                        float naRate = 0.0f);
+
+#endif
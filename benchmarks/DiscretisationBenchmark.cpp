@@ -0,0 +1,56 @@
+#include "BenchmarkData.h"
+
+#include "../core/DiscretisationSettings.h"
+#include "../core/Discretiser.h"
+#include "../core/Network.h"
+
+#include <benchmark/benchmark.h>
+
+/**
+ * Discretises generated numeric observations with the given method, the
+ * arguments are the number of variables and the number of samples.
+ */
+static void BM_Discretise(benchmark::State& state, const std::string& method,
+                          const std::string& parameterID,
+                          const std::string& parameter)
+{
+	const auto observations =
+	    generateNumericObservations(state.range(0), state.range(1));
+	DiscretisationSettings settings;
+	for(const auto& name : observations.getRowNames()) {
+		if(parameterID.empty()) {
+			settings.addToTree(name, method);
+		} else {
+			settings.addToTree(name, method, parameterID, parameter);
+		}
+	}
+
+	for(auto _ : state) {
+		Network network;
+		Matrix<int> discretised;
+		Discretiser discretiser(observations, discretised, network);
+		discretiser.setJsonTree(settings);
+		discretiser.discretise();
+		benchmark::DoNotOptimize(discretised);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0) *
+	                        state.range(1));
+}
+
+#define DISCRETISATION_BENCHMARK(name, method, parameterID, parameter)         \
+	BENCHMARK_CAPTURE(BM_Discretise, name, method, parameterID, parameter)     \
+	    ->Args({200, 1000})                                                    \
+	    ->Args({20, 100000})                                                   \
+	    ->Unit(benchmark::kMillisecond)
+
+DISCRETISATION_BENCHMARK(ceil, "Ceil", "", "");
+DISCRETISATION_BENCHMARK(floor, "Floor", "", "");
+DISCRETISATION_BENCHMARK(round, "Round", "", "");
+DISCRETISATION_BENCHMARK(arithmeticMean, "ArithmeticMean", "", "");
+DISCRETISATION_BENCHMARK(harmonicMean, "HarmonicMean", "", "");
+DISCRETISATION_BENCHMARK(median, "Median", "", "");
+DISCRETISATION_BENCHMARK(threshold, "Threshold", "threshold", "5.0");
+DISCRETISATION_BENCHMARK(bracketMedians, "BracketMedians", "buckets", "4");
+DISCRETISATION_BENCHMARK(pearsonTukey, "PearsonTukey", "", "");
+DISCRETISATION_BENCHMARK(zScore, "Z-Score", "", "");
+DISCRETISATION_BENCHMARK(mapping, "None", "", "");
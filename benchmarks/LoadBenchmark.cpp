@@ -0,0 +1,65 @@
+#include "BenchmarkData.h"
+
+#include "../core/Matrix.h"
+#include "../core/Network.h"
+
+#include <benchmark/benchmark.h>
+
+static void BM_LoadObservationMatrix(benchmark::State& state)
+{
+	const std::string file = benchmarkDataFile("StudentData.txt");
+	for(auto _ : state) {
+		Matrix<std::string> observations(file, false, true);
+		benchmark::DoNotOptimize(observations);
+	}
+}
+BENCHMARK(BM_LoadObservationMatrix)->Unit(benchmark::kMillisecond);
+
+static void BM_LoadGeneratedObservationMatrix(benchmark::State& state)
+{
+	const auto& generated = generateNetwork(state.range(0), 3, 1000);
+	for(auto _ : state) {
+		Matrix<std::string> observations(generated.dataFile, false, true);
+		benchmark::DoNotOptimize(observations);
+	}
+}
+BENCHMARK(BM_LoadGeneratedObservationMatrix)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_ReadStudentNetwork(benchmark::State& state)
+{
+	const std::string na = benchmarkDataFile("Student.na");
+	const std::string sif = benchmarkDataFile("Student.sif");
+	for(auto _ : state) {
+		Network network;
+		network.readNetwork(na);
+		network.readNetwork(sif);
+		benchmark::DoNotOptimize(network);
+	}
+}
+BENCHMARK(BM_ReadStudentNetwork);
+
+static void BM_ReadInsuranceNetwork(benchmark::State& state)
+{
+	const std::string tgf = benchmarkDataFile("insurance.tgf");
+	for(auto _ : state) {
+		Network network;
+		network.readNetwork(tgf);
+		benchmark::DoNotOptimize(network);
+	}
+}
+BENCHMARK(BM_ReadInsuranceNetwork);
+
+static void BM_ReadGeneratedNetwork(benchmark::State& state)
+{
+	const auto& generated = generateNetwork(state.range(0), 3, 1000);
+	for(auto _ : state) {
+		Network network;
+		network.readNetwork(generated.networkFile);
+		benchmark::DoNotOptimize(network);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ReadGeneratedNetwork)->Arg(100)->Arg(1000)->Arg(10000);
@@ -0,0 +1,102 @@
+#include "BenchmarkData.h"
+
+#include "../core/NetworkController.h"
+#include "../core/Parser.h"
+#include "../core/QueryExecuter.h"
+
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <memory>
+
+namespace {
+NetworkController& studentController()
+{
+	static std::unique_ptr<NetworkController> controller;
+	if(!controller) {
+		controller = std::make_unique<NetworkController>();
+		controller->loadNetwork(benchmarkDataFile("Student.na"));
+		controller->loadNetwork(benchmarkDataFile("Student.sif"));
+		controller->loadObservations(benchmarkDataFile("StudentData.txt"),
+		                             benchmarkDataFile("controlStudent.json"));
+		controller->trainNetwork();
+	}
+	return *controller;
+}
+
+NetworkController& generatedController(unsigned int nodes)
+{
+	static std::map<unsigned int, std::unique_ptr<NetworkController>>
+	    controllers;
+	auto& controller = controllers[nodes];
+	if(!controller) {
+		const auto& generated = generateNetwork(nodes, 3, 1000);
+		controller = std::make_unique<NetworkController>();
+		controller->loadNetwork(generated.networkFile);
+		controller->loadObservations(generated.dataFile, generated.controlFile);
+		controller->trainNetwork();
+	}
+	return *controller;
+}
+
+void runQuery(benchmark::State& state, NetworkController& controller,
+              const std::string& query)
+{
+	for(auto _ : state) {
+		Parser parser(query, controller);
+		QueryExecuter executer = parser.parseQuery();
+		benchmark::DoNotOptimize(executer.execute());
+	}
+}
+
+// Query on the generated network relating the last node to the first one
+std::string generatedQuery(unsigned int nodes, const std::string& type)
+{
+	const std::string first = "N0";
+	const std::string last = "N" + std::to_string(nodes - 1);
+	if(type == "joint") {
+		return "? " + last + " = v0 " + first + " = v0";
+	}
+	if(type == "conditional") {
+		return "? " + last + " = v0 | " + first + " = v0";
+	}
+	if(type == "argmax") {
+		return "? argmax ( " + last + " ) | " + first + " = v0";
+	}
+	if(type == "intervention") {
+		return "? " + last + " = v0 ! do " + first + " = v1";
+	}
+	return "? " + last + " = v0 ! do " + first + " = v1 | " + last + " = v1";
+}
+}
+
+static void BM_StudentQuery(benchmark::State& state, const std::string& query)
+{
+	runQuery(state, studentController(), query);
+}
+BENCHMARK_CAPTURE(BM_StudentQuery, joint, "? Grade = g1 Difficulty = d0");
+BENCHMARK_CAPTURE(BM_StudentQuery, conditional,
+                  "? Grade = g1 | Intelligence = i0 Difficulty = d0");
+BENCHMARK_CAPTURE(BM_StudentQuery, argmax,
+                  "? argmax ( Grade ) | Intelligence = i1");
+BENCHMARK_CAPTURE(BM_StudentQuery, intervention,
+                  "? Letter = l1 ! do Grade = g1");
+BENCHMARK_CAPTURE(BM_StudentQuery, counterfactual,
+                  "? Letter = l1 ! do Grade = g1 | Letter = l0 Grade = g3");
+
+static void BM_GeneratedQuery(benchmark::State& state, const std::string& type)
+{
+	const unsigned int nodes = state.range(0);
+	runQuery(state, generatedController(nodes), generatedQuery(nodes, type));
+}
+#define GENERATED_QUERY_BENCHMARK(type)                                        \
+	BENCHMARK_CAPTURE(BM_GeneratedQuery, type, #type)                          \
+	    ->Arg(20)                                                              \
+	    ->Arg(60)                                                              \
+	    ->Unit(benchmark::kMicrosecond)
+
+GENERATED_QUERY_BENCHMARK(joint);
+GENERATED_QUERY_BENCHMARK(conditional);
+GENERATED_QUERY_BENCHMARK(argmax);
+GENERATED_QUERY_BENCHMARK(intervention);
+GENERATED_QUERY_BENCHMARK(counterfactual);
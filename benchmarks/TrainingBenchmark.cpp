@@ -0,0 +1,117 @@
+#include "BenchmarkData.h"
+
+#include "../core/DataDistribution.h"
+#include "../core/Discretiser.h"
+#include "../core/EM.h"
+#include "../core/Network.h"
+#include "../core/ObservationCodes.h"
+
+#include <benchmark/benchmark.h>
+
+namespace {
+/**
+ * A network together with its discretised observations
+ */
+struct TrainingInput
+{
+	TrainingInput(const std::vector<std::string>& networkFiles,
+	              const std::string& dataFile, const std::string& controlFile)
+	{
+		for(const auto& file : networkFiles) {
+			network.readNetwork(file);
+		}
+		Discretiser discretiser(Matrix<std::string>(dataFile, false, true),
+		                        controlFile, observations, network);
+	}
+
+	Network network;
+	ObservationCodes observations;
+};
+
+TrainingInput studentInput(const std::string& dataFile)
+{
+	return TrainingInput({benchmarkDataFile("Student.na"),
+	                      benchmarkDataFile("Student.sif")},
+	                     benchmarkDataFile(dataFile),
+	                     benchmarkDataFile("controlStudent.json"));
+}
+
+TrainingInput generatedInput(unsigned int nodes, float naRate)
+{
+	const auto& generated = generateNetwork(nodes, 3, 1000, naRate);
+	return TrainingInput({generated.networkFile}, generated.dataFile,
+	                     generated.controlFile);
+}
+
+void distribute(TrainingInput& input)
+{
+	DataDistribution distribution(input.network, input.observations);
+	distribution.assignObservationsToNodes();
+	distribution.distributeObservations();
+}
+
+void runDistribution(benchmark::State& state, TrainingInput input)
+{
+	for(auto _ : state) {
+		state.PauseTiming();
+		Network network(input.network);
+		state.ResumeTiming();
+		DataDistribution distribution(network, input.observations);
+		distribution.assignObservationsToNodes();
+		distribution.distributeObservations();
+		benchmark::DoNotOptimize(network);
+	}
+	state.SetItemsProcessed(state.iterations() *
+	                        input.observations.getColCount());
+}
+
+void runEM(benchmark::State& state, TrainingInput input)
+{
+	distribute(input);
+	EMSettings settings;
+	settings.differenceThreshold = 0.001f;
+	settings.maxRuns = 100000;
+	unsigned int runs = 0;
+	for(auto _ : state) {
+		state.PauseTiming();
+		Network network(input.network);
+		state.ResumeTiming();
+		EM em(network, input.observations, settings);
+		runs = em.getNumberOfRuns();
+	}
+	state.counters["emRuns"] = runs;
+}
+}
+
+static void BM_DistributeObservationsStudent(benchmark::State& state)
+{
+	runDistribution(state, studentInput("StudentData.txt"));
+}
+BENCHMARK(BM_DistributeObservationsStudent)->Unit(benchmark::kMillisecond);
+
+static void BM_DistributeObservationsGenerated(benchmark::State& state)
+{
+	runDistribution(state, generatedInput(state.range(0), 0.0f));
+}
+BENCHMARK(BM_DistributeObservationsGenerated)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_EMStudentComplete(benchmark::State& state)
+{
+	runEM(state, studentInput("StudentData.txt"));
+}
+BENCHMARK(BM_EMStudentComplete)->Unit(benchmark::kMillisecond);
+
+static void BM_EMStudentMissing(benchmark::State& state)
+{
+	runEM(state, studentInput("dataStudent60.txt"));
+}
+BENCHMARK(BM_EMStudentMissing)->Unit(benchmark::kMillisecond);
+
+static void BM_EMGeneratedMissing(benchmark::State& state)
+{
+	runEM(state, generatedInput(state.range(0), 0.1f));
+}
+BENCHMARK(BM_EMGeneratedMissing)->Arg(50)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,154 @@
+#include "AdjacencyList.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+AdjacencyList::AdjacencyList(unsigned int nodeCount) { reset(nodeCount); }
+
+void AdjacencyList::reset(unsigned int nodeCount)
+{
+	parents_.reset(nodeCount);
+	children_.reset(nodeCount);
+}
+
+void AdjacencyList::addEdges(const std::vector<Edge>& edges)
+{
+	std::vector<Edge> all;
+	all.reserve(getEdgeCount() + edges.size());
+	for(unsigned int child = 0; child < size(); child++) {
+		for(auto parent : getParents(child)) {
+			all.emplace_back(child, parent);
+		}
+	}
+	for(const auto& e : edges) {
+		checkID(e.first);
+		checkID(e.second);
+		all.push_back(e);
+	}
+	std::sort(all.begin(), all.end());
+	all.erase(std::unique(all.begin(), all.end()), all.end());
+	parents_.build(size(), all);
+	for(auto& e : all) {
+		std::swap(e.first, e.second);
+	}
+	std::sort(all.begin(), all.end());
+	children_.build(size(), all);
+}
+
+void AdjacencyList::addEdge(unsigned int child, unsigned int parent)
+{
+	checkID(child);
+	checkID(parent);
+	if(!hasEdge(child, parent)) {
+		parents_.insert(child, parent);
+		children_.insert(parent, child);
+	}
+}
+
+void AdjacencyList::removeEdge(unsigned int child, unsigned int parent)
+{
+	checkID(child);
+	checkID(parent);
+	if(hasEdge(child, parent)) {
+		parents_.erase(child, parent);
+		children_.erase(parent, child);
+	}
+}
+
+bool AdjacencyList::hasEdge(unsigned int child, unsigned int parent) const
+{
+	return child < size() && parents_.contains(child, parent);
+}
+
+AdjacencyList::Range AdjacencyList::getParents(unsigned int id) const
+{
+	return parents_.get(id);
+}
+
+AdjacencyList::Range AdjacencyList::getChildren(unsigned int id) const
+{
+	return children_.get(id);
+}
+
+unsigned int AdjacencyList::size() const
+{
+	return parents_.offsets.size() - 1;
+}
+
+size_t AdjacencyList::getEdgeCount() const { return parents_.targets.size(); }
+
+void AdjacencyList::checkID(unsigned int id) const
+{
+	if(id >= size()) {
+		throw std::invalid_argument("Invalid node identifier " +
+		                            std::to_string(id));
+	}
+}
+
+std::ostream& operator<<(std::ostream& os, const AdjacencyList& a)
+{
+	for(unsigned int id = 0; id < a.size(); id++) {
+		os << id << ":";
+		for(auto parent : a.getParents(id)) {
+			os << " " << parent;
+		}
+		os << "\n";
+	}
+	return os;
+}
+
+void AdjacencyList::CSR::reset(unsigned int nodeCount)
+{
+	offsets.assign(nodeCount + 1, 0);
+	targets.clear();
+}
+
+void AdjacencyList::CSR::build(unsigned int nodeCount,
+                               const std::vector<Edge>& edges)
+{
+	offsets.assign(nodeCount + 1, 0);
+	for(const auto& e : edges) {
+		offsets[e.first + 1]++;
+	}
+	for(unsigned int id = 0; id < nodeCount; id++) {
+		offsets[id + 1] += offsets[id];
+	}
+	targets.resize(edges.size());
+	for(size_t i = 0; i < edges.size(); i++) {
+		targets[i] = edges[i].second;
+	}
+}
+
+bool AdjacencyList::CSR::contains(unsigned int id, unsigned int target) const
+{
+	auto range = get(id);
+	return std::binary_search(range.begin(), range.end(), target);
+}
+
+void AdjacencyList::CSR::insert(unsigned int id, unsigned int target)
+{
+	auto first = targets.begin() + offsets[id];
+	auto last = targets.begin() + offsets[id + 1];
+	targets.insert(std::lower_bound(first, last, target), target);
+	for(size_t i = id + 1; i < offsets.size(); i++) {
+		offsets[i]++;
+	}
+}
+
+void AdjacencyList::CSR::erase(unsigned int id, unsigned int target)
+{
+	auto first = targets.begin() + offsets[id];
+	auto last = targets.begin() + offsets[id + 1];
+	targets.erase(std::lower_bound(first, last, target));
+	for(size_t i = id + 1; i < offsets.size(); i++) {
+		offsets[i]--;
+	}
+}
+
+AdjacencyList::Range AdjacencyList::CSR::get(unsigned int id) const
+{
+	if(id + 1 >= offsets.size()) {
+		return Range(nullptr, nullptr);
+	}
+	return Range(targets.data() + offsets[id], targets.data() + offsets[id + 1]);
+}
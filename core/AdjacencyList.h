@@ -0,0 +1,164 @@
+#ifndef ADJACENCYLIST_H
+#define ADJACENCYLIST_H
+
+#include <iostream>
+#include <utility>
+#include <vector>
+
+/**
+ * Sparse storage of the network structure. Parents and children of every node
+ * are kept in compressed sparse row (CSR) form: the neighbours of all nodes are
+ * stored in one array, sorted by node and identifier, and an offset array
+ * indicates where the neighbours of each node start. Thus, the memory
+ * consumption and the cost of structural operations scale with the number of
+ * edges instead of the squared number of nodes.
+ */
+class AdjacencyList
+{
+	public:
+	//Edge given as a pair (child, parent)
+	using Edge = std::pair<unsigned int, unsigned int>;
+
+	/**
+	 * Read-only view on the neighbours of a node
+	 */
+	class Range
+	{
+		public:
+		Range(const unsigned int* begin, const unsigned int* end)
+		    : begin_(begin), end_(end)
+		{
+		}
+		const unsigned int* begin() const { return begin_; }
+		const unsigned int* end() const { return end_; }
+		size_t size() const { return end_ - begin_; }
+		bool empty() const { return begin_ == end_; }
+		unsigned int operator[](size_t i) const { return begin_[i]; }
+
+		private:
+		const unsigned int* begin_;
+		const unsigned int* end_;
+	};
+
+	/**AdjacencyList
+	 *
+	 * @param nodeCount, number of nodes
+	 *
+	 * @return an AdjacencyList without edges
+	 */
+	explicit AdjacencyList(unsigned int nodeCount = 0);
+
+	/**reset
+	 *
+	 * @param nodeCount, number of nodes
+	 *
+	 * Removes all edges and sets the number of nodes
+	 */
+	void reset(unsigned int nodeCount);
+
+	/**addEdges
+	 *
+	 * @param edges, edges given as (child, parent) pairs
+	 *
+	 * Adds all given edges at once, duplicates are ignored.
+	 *
+	 * @throw invalid_argument if an identifier exceeds the number of nodes
+	 */
+	void addEdges(const std::vector<Edge>& edges);
+
+	/**addEdge
+	 *
+	 * @param child, identifier of the child
+	 * @param parent, identifier of the parent
+	 *
+	 * Adds a single edge, nothing happens if it exists already.
+	 *
+	 * @throw invalid_argument if an identifier exceeds the number of nodes
+	 */
+	void addEdge(unsigned int child, unsigned int parent);
+
+	/**removeEdge
+	 *
+	 * @param child, identifier of the child
+	 * @param parent, identifier of the parent
+	 *
+	 * Removes a single edge, nothing happens if it does not exist.
+	 *
+	 * @throw invalid_argument if an identifier exceeds the number of nodes
+	 */
+	void removeEdge(unsigned int child, unsigned int parent);
+
+	/**hasEdge
+	 *
+	 * @param child, identifier of the child
+	 * @param parent, identifier of the parent
+	 *
+	 * @return true if parent is a parent of child
+	 */
+	bool hasEdge(unsigned int child, unsigned int parent) const;
+
+	/**getParents
+	 *
+	 * @param id, identifier of a node
+	 *
+	 * @return the parents of the node in ascending order, empty for unknown nodes
+	 */
+	Range getParents(unsigned int id) const;
+
+	/**getChildren
+	 *
+	 * @param id, identifier of a node
+	 *
+	 * @return the children of the node in ascending order, empty for unknown nodes
+	 */
+	Range getChildren(unsigned int id) const;
+
+	/**size
+	 *
+	 * @return the number of nodes
+	 */
+	unsigned int size() const;
+
+	/**getEdgeCount
+	 *
+	 * @return the number of edges
+	 */
+	size_t getEdgeCount() const;
+
+	/**operator<<
+	 *
+	 * Writes the parents of every node, one node per line
+	 */
+	friend std::ostream& operator<<(std::ostream& os, const AdjacencyList& a);
+
+	private:
+	/**
+	 * One direction of the graph in CSR form
+	 */
+	struct CSR {
+		//Offsets of the neighbours of every node, one entry more than nodes
+		std::vector<unsigned int> offsets;
+		//Neighbours of all nodes
+		std::vector<unsigned int> targets;
+
+		void reset(unsigned int nodeCount);
+		void build(unsigned int nodeCount, const std::vector<Edge>& edges);
+		bool contains(unsigned int id, unsigned int target) const;
+		void insert(unsigned int id, unsigned int target);
+		void erase(unsigned int id, unsigned int target);
+		Range get(unsigned int id) const;
+	};
+
+	/**checkID
+	 *
+	 * @throw invalid_argument if id exceeds the number of nodes
+	 */
+	void checkID(unsigned int id) const;
+
+	//Parents of every node
+	CSR parents_;
+	//Children of every node
+	CSR children_;
+};
+
+#endif
@@ -1,41 +1,72 @@
 #ifndef COMBINATIONS_H
 #define COMBINATIONS_H
+#include <cstddef>
 #include <vector>
-#include <unordered_map>
-#include <iostream>
 
+/**
+ * Enumerates all assignments of values to the keys without materialising
+ * them. This class works as a mixed-radix counter: each key is a digit
+ * whose radix is the number of values of that key. The current assignment
+ * is written into a caller provided vector, hence stepping through the
+ * enumeration does not allocate. The last key changes fastest.
+ */
 template<typename T>
-class Combinations{
+class CombinationCounter{
 	public:
-	/**Combinations()
+	/**CombinationCounter
 	 *
 	 * @param keys a vector containing a key for each exchangeable position
 	 * @param values a map that holds the possible values for each key
+	 * @param assignment vector, indexed by key, that receives the current assignment
 	 *
-	 * @return a Combinations Object
+	 * @return a CombinationCounter object positioned at the first assignment
+	 */
+	CombinationCounter(const std::vector<unsigned int>& keys,
+	                   const std::vector<std::vector<T>>& values,
+	                   std::vector<T>& assignment);
+
+	CombinationCounter& operator=(const CombinationCounter&) = delete;
+	CombinationCounter& operator=(CombinationCounter&&) = delete;
+
+	/**next
 	 *
-	 * This class creates all enumerations for the enumeration problem without replacement and without regard to sequence
+	 * @return true if the counter advanced to a new assignment, false if
+	 * all assignments have been enumerated. In the latter case the counter
+	 * wraps around to the first assignment.
 	 */
-	Combinations(const std::vector<unsigned int>& keys, const std::vector<std::vector<T>>& values);
+	bool next();
 
-	Combinations& operator=(const Combinations&) = delete;
-	Combinations& operator=(Combinations&&) = delete;
+	/**reset
+	 *
+	 * Moves the counter back to the first assignment
+	 */
+	void reset();
 
-	/**createCombinations
+	/**empty
 	 *
-	 * @param position The position of the start key (0 if all enumeration should be constructed)
+	 * @return true if there is no assignment at all, i.e. a key without values
+	 */
+	bool empty() const;
+
+	/**size
 	 *
-	 * Recursively creates a enumeration of all possible combinations given the keys and their possible values
+	 * @return the total number of assignments
 	 */
-	void createCombinations(unsigned int position = 0);
+	size_t size() const;
 
-	/**getResult
+	/**getDigits
 	 *
-	 * @return vector Containing all possible combinations
+	 * @return the position of the current value for every key
+	 */
+	const std::vector<unsigned int>& getDigits() const;
+
+	/**setDigits
+	 *
+	 * @param digits positions of the values for every key, as returned by getDigits
 	 *
-	 * Returns the enumeration result
+	 * Moves the counter to the assignment described by digits
 	 */
-	std::vector<std::vector<T>> getResult();
+	void setDigits(const std::vector<unsigned int>& digits);
 
 	private:
 
@@ -45,36 +76,78 @@ class Combinations{
 	//Vector to store the possible values per key
 	const std::vector<std::vector<T>>& values_;
 
-	//Vector to store the temporal assignment
-	std::vector<T> temp_;
+	//Vector receiving the current assignment
+	std::vector<T>& assignment_;
 
-	//Vector to store the entire enumeration
-	std::vector<std::vector<T>> result_;
+	//Current position in the value list of every key
+	std::vector<unsigned int> digits_;
 };
-#endif
 
 template<typename T>
-Combinations<T>::Combinations(const std::vector<unsigned int>& keys, const std::vector<std::vector<T>>& values)
-	:keys_(keys),values_(values)
+CombinationCounter<T>::CombinationCounter(const std::vector<unsigned int>& keys,
+                                          const std::vector<std::vector<T>>& values,
+                                          std::vector<T>& assignment)
+	:keys_(keys),values_(values),assignment_(assignment),digits_(keys.size(),0)
 	{
-	temp_.resize(values.size());
+	reset();
+	}
+
+template<typename T>
+bool CombinationCounter<T>::next(){
+	for (size_t pos = keys_.size(); pos-- > 0;){
+		const unsigned int key = keys_[pos];
+		const auto& v = values_[key];
+		if (++digits_[pos] < v.size()){
+			assignment_[key] = v[digits_[pos]];
+			return true;
+			}
+		digits_[pos] = 0;
+		assignment_[key] = v[0];
+		}
+	return false;
 	}
 
 template<typename T>
-void Combinations<T>::createCombinations(unsigned int position){
-	if (position == keys_.size()){
-		result_.push_back(temp_);
+void CombinationCounter<T>::reset(){
+	if (empty()){
+		return;
+		}
+	for (size_t pos = 0; pos < keys_.size(); pos++){
+		digits_[pos] = 0;
+		assignment_[keys_[pos]] = values_[keys_[pos]][0];
 		}
-	else {
-		for (auto& v : values_[keys_[position]]){
-			temp_[keys_[position]]=v;
-			createCombinations(position+1);
+	}
+
+template<typename T>
+bool CombinationCounter<T>::empty() const{
+	for (auto key : keys_){
+		if (values_[key].empty()){
+			return true;
 			}
-		}	
+		}
+	return false;
 	}
 
 template<typename T>
-std::vector<std::vector<T>> Combinations<T>::getResult(){
-	return result_;
+size_t CombinationCounter<T>::size() const{
+	size_t result = 1;
+	for (auto key : keys_){
+		result *= values_[key].size();
+		}
+	return result;
 	}
 
+template<typename T>
+const std::vector<unsigned int>& CombinationCounter<T>::getDigits() const{
+	return digits_;
+	}
+
+template<typename T>
+void CombinationCounter<T>::setDigits(const std::vector<unsigned int>& digits){
+	for (size_t pos = 0; pos < keys_.size(); pos++){
+		digits_[pos] = digits[pos];
+		assignment_[keys_[pos]] = values_[keys_[pos]][digits[pos]];
+		}
+	}
+
+#endif
@@ -1,6 +1,21 @@
 #include "DataDistribution.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
 
 DataDistribution::DataDistribution(Network& network, Matrix<int>& observations)
+    : network_(network),
+      convertedObservations_(observations),
+      observations_(convertedObservations_),
+      observationsMap_(network.getObservationsMap()),
+      observationsMapR_(network.getObservationsMapR())
+{
+}
+
+DataDistribution::DataDistribution(Network& network,
+                                   const ObservationCodes& observations)
     : network_(network),
       observations_(observations),
       observationsMap_(network.getObservationsMap()),
@@ -21,6 +36,7 @@ DataDistribution::computeParentCombinations(std::vector<unsigned int> parents)
 
 void DataDistribution::assignObservationsToNodes()
 {
+	CT_TRACE_SCOPE("DataDistribution::assignObservationsToNodes");
 	for(auto& n : network_.getNodes()) {
 		n.clearNameVectors();
 		int row = observations_.findRow(n.getName());
@@ -33,7 +49,33 @@ void DataDistribution::assignObservationsToNodes()
 		n.setUniqueValuesExcludingNA(
 		    observations_.getUniqueRowValues(n.getObservationRow(), -1));
 	}
+	assignNames();
+}
 
+void DataDistribution::assignObservationsToNodes(
+    const std::vector<std::string>& rowNames,
+    const std::vector<std::vector<int>>& uniqueValues)
+{
+	CT_TRACE_SCOPE("DataDistribution::assignObservationsToNodes");
+	for(auto& n : network_.getNodes()) {
+		n.clearNameVectors();
+		const auto it = std::find(rowNames.begin(), rowNames.end(), n.getName());
+		if(it == rowNames.end()) {
+			throw std::invalid_argument(n.getName()+" not contained in data");
+		}
+		const unsigned int row = it - rowNames.begin();
+		n.setObservationRow(row);
+		n.setUniqueValues(uniqueValues[row]);
+		std::vector<int> valuesExcludingNA;
+		std::remove_copy(uniqueValues[row].begin(), uniqueValues[row].end(),
+		                 std::back_inserter(valuesExcludingNA), -1);
+		n.setUniqueValuesExcludingNA(valuesExcludingNA);
+	}
+	assignNames();
+}
+
+void DataDistribution::assignNames()
+{
 	for(auto& n : network_.getNodes()) {
 		n.setParentCombinations(computeParentCombinations(n.getParents()));
 		assignValueNames(n);
@@ -55,115 +97,106 @@ void DataDistribution::assignValueNames(Node& n)
 
 void DataDistribution::assignParentNames(Node& n)
 {
-	if(n.getNumberOfParents() > 1) {
-		std::vector<std::vector<int>>
-		uniqueValuesExcludingNA (network_.getNodes().size(),{-1});
-		for(const auto& id : n.getParents()) {
-			uniqueValuesExcludingNA[id] =
-			    network_.getNode(id).getUniqueValuesExcludingNA();
-		}
+	const auto& parents = n.getParents();
+	if(parents.empty()) {
+		n.setParentValueNameLists({});
+		n.setParentValues({});
+		return;
+	}
 
-		Combinations<int> comb(n.getParents(), uniqueValuesExcludingNA);
-		comb.createCombinations(0);
-		std::vector<std::vector<int>> tempParentNames = comb.getResult();
-		std::vector<std::vector<int>> parentValues;
-		for(auto& vec : tempParentNames) {
-			std::string temp = "";
-			std::vector<int> value;
-			for(unsigned int key = 0; key < n.getNumberOfParents(); key++) {
-				int parentRow =
-				    network_.getNode(n.getParents()[key]).getObservationRow();
-				temp = temp +
-				       observationsMapR_[std::make_pair(vec[n.getParents()[key]], parentRow)] +
-				       ",";
-					value.push_back(vec[n.getParents()[key]]);
-			}
-			temp.erase(temp.end() - 1);
-			n.addParentValueName(temp);
-			parentValues.push_back(value);
+	// Keys and value lists are indexed by the position of the parent,
+	// such that neither depends on the size of the network.
+	std::vector<unsigned int> keys(parents.size());
+	std::vector<std::vector<int>> uniqueValuesExcludingNA(parents.size());
+	std::vector<std::vector<std::string>> nameLists(parents.size());
+	for(unsigned int key = 0; key < parents.size(); key++) {
+		const Node& parent = network_.getNode(parents[key]);
+		if(parent.getNumberOfUniqueValuesExcludingNA() >
+		   std::numeric_limits<Node::ParentValue>::max()) {
+			throw std::invalid_argument("Node " + parent.getName() +
+			                            " contains too many distinct values");
 		}
-		n.setParentValues(parentValues);
-	} else if(n.getNumberOfParents() == 1) {
-		int parentRow = network_.getNode(n.getParents()[0]).getObservationRow();
-		for(auto& v :
-		    network_.getNode(n.getParents()[0]).getUniqueValuesExcludingNA()) {
-			n.addParentValueName(
-			    observationsMapR_[std::make_pair(v, parentRow)]);
+		keys[key] = key;
+		uniqueValuesExcludingNA[key] = parent.getUniqueValuesExcludingNA();
+		for(const auto& value : uniqueValuesExcludingNA[key]) {
+			nameLists[key].push_back(observationsMapR_[std::make_pair(
+			    value, parent.getObservationRow())]);
 		}
-		std::vector<std::vector<int>> pValues;
-		for (auto& value : network_.getNode(n.getParents()[0]).getUniqueValuesExcludingNA()){
-			pValues.push_back({value});
-		}
-		n.setParentValues(pValues);
-
-	} else {
-		n.addParentValueName("1");
-		std::vector<std::vector<int>> noParents{{}};
-		n.setParentValues(noParents);
 	}
-}
+	n.setParentValueNameLists(std::move(nameLists));
 
-int DataDistribution::getObservationColIndex(unsigned int sample, const Node& n)
-{
-	if(n.getNumberOfUniqueValues() != n.getNumberOfUniqueValuesExcludingNA()) {
-		return observations_(sample, n.getObservationRow()) + 1;
-	} else {
-		return observations_(sample, n.getObservationRow());
+	std::vector<int> value(parents.size());
+	CombinationCounter<int> comb(keys, uniqueValuesExcludingNA, value);
+	std::vector<Node::ParentValue> parentValues;
+	if(!comb.empty()) {
+		parentValues.reserve(comb.size() * parents.size());
+		do {
+			parentValues.insert(parentValues.end(), value.begin(), value.end());
+		} while(comb.next());
 	}
+	n.setParentValues(parentValues);
 }
 
-int DataDistribution::getObservationRowIndex(unsigned int sample, Node& n)
+template <typename Code>
+void DataDistribution::countObservations(Table<int>& obsMatrix, Node& n)
 {
-	if(n.getParents().empty()) {
-		return 0;
-	}
-	int index = 0;
-	const auto& parentID = n.getParents();
-	for(unsigned int i = 0; i< parentID.size(); i++) {
-		Node& pn = network_.getNode(parentID[i]);
-		int value = observations_(sample, pn.getObservationRow());
-		if(value == -1) {
-			return -1;
-		}
-		index += n.getFactor(i) * value;
+	const auto& parentIDs = n.getParents();
+	std::vector<const Code*> parentCodes(parentIDs.size());
+	for(unsigned int i = 0; i < parentIDs.size(); i++) {
+		parentCodes[i] = observations_.getRow<Code>(
+		    network_.getNode(parentIDs[i]).getObservationRow());
 	}
-	return index;
-}
-
-void DataDistribution::countObservations(Matrix<int>& obsMatrix, Node& n)
-{
+	const Code* codes = observations_.getRow<Code>(n.getObservationRow());
+	// The code is the value plus one, which is the column of the value if
+	// column 0 holds the missing values
+	const unsigned int offset = n.hasNA() ? 0 : 1;
 	for(unsigned int sample = 0; sample < observations_.getColCount();
 	    sample++) {
+		int row = 0;
+		bool parentsObserved = true;
+		for(unsigned int i = 0; i < parentCodes.size(); i++) {
+			const Code parent = parentCodes[i][sample];
+			if(parent == ObservationCodes::NA) {
+				parentsObserved = false;
+				break;
+			}
+			row += n.getFactor(i) * (parent - 1);
+		}
 
-		int column = getObservationColIndex(sample, n);
-		
-		network_.computeFactor(n);
-	
-		int row = getObservationRowIndex(sample, n);
-
-		if(row != -1) {
-			obsMatrix(column, row)++;
+		if(parentsObserved) {
+			obsMatrix(codes[sample] - offset, row)++;
 		}
 	}
 }
 
 void DataDistribution::distributeObservations()
+{
+	CT_TRACE_SCOPE("DataDistribution::distributeObservations");
+	createMatrices();
+	countObservations();
+}
+
+void DataDistribution::createMatrices()
 {
 	// Generating matrices
 	for(auto& n : network_.getNodes()) {
 		// Generating suitable matrices
-		Matrix<int> obsMatrix =
-		    Matrix<int>(n.getValueNames(), n.getParentValueNames(), 0);
-		Matrix<float> probMatrix =
-		    Matrix<float>(n.getValueNamesProb(), n.getParentValueNames(), 0.0f);
-		// Count observations
-		countObservations(obsMatrix, n);
+		const auto rows = n.getNumberOfParentValues();
+		Table<int> obsMatrix(n.getValueNames().size(), rows, 0);
+		Table<float> probMatrix(n.getValueNamesProb().size(), rows, 0.0f);
 		// Store matrices
 		n.setObservations(obsMatrix);
-		n.setObservationBackup(obsMatrix);
 		n.setProbability(probMatrix);
-		n.initialiseRevFactor();
 		n.clearDynProgMatrix();
-		n.createBackup();
+		network_.computeFactor(n);
 	}
 }
+
+void DataDistribution::countObservations()
+{
+	observations_.visit([this](auto code) {
+		for(auto& n : network_.getNodes()) {
+			countObservations<decltype(code)>(n.getObservationMatrix(), n);
+		}
+	});
+}
@@ -3,6 +3,7 @@
 
 #include"Network.h"
 #include"Combinations.h"
+#include"ObservationCodes.h"
 #include<map>
 
 class DataDistribution{
@@ -14,9 +15,24 @@ class DataDistribution{
 	 *
 	 * @return DataDistribution object
 	 *
+	 * Conversion shim, which copies the observations into ObservationCodes.
+	 * New code should pass ObservationCodes, such that a single copy of the
+	 * observations is held.
 	 */
 	DataDistribution(Network& network, Matrix<int>& observations);
 
+	/**DataDistribution
+	 *
+	 * @param network, A reference to a network
+	 * @param observations, A reference to the discretised observations. They
+	 * are read when the observations are counted, hence they may be refilled
+	 * with the next chunk of samples in between.
+	 *
+	 * @return DataDistribution object
+	 *
+	 */
+	DataDistribution(Network& network, const ObservationCodes& observations);
+
 	DataDistribution& operator=(const DataDistribution&) = delete;
 	DataDistribution& operator=(DataDistribution&&) = delete;
 
@@ -27,6 +43,19 @@ class DataDistribution{
 	 */
 	void assignObservationsToNodes();
 
+	/**assignObservationsToNodes
+	 *
+	 * @param rowNames, the names of the rows of the observations
+	 * @param uniqueValues, the sorted values of every row, including -1
+	 * if the row contains missing values
+	 *
+	 * Like assignObservationsToNodes(), but for observations that are not
+	 * held in memory as a whole.
+	 */
+	void assignObservationsToNodes(
+	    const std::vector<std::string>& rowNames,
+	    const std::vector<std::vector<int>>& uniqueValues);
+
 	/**distributeObservations
 	 *
 	 * Counts the number of observatoins of a given value,
@@ -35,8 +64,29 @@ class DataDistribution{
 	 * CPT.
 	 */
 	void distributeObservations();
+
+	/**createMatrices
+	 *
+	 * Initialises the observation matrix of each node with zero counts and
+	 * creates a properly sized CPT.
+	 */
+	void createMatrices();
+
+	/**countObservations
+	 *
+	 * Adds the observations to the observation matrices of the nodes. Calling
+	 * this for consecutive chunks of samples yields the counts of all samples.
+	 */
+	void countObservations();
 	private:
 
+	/**assignNames
+	 *
+	 * Computes the parent combinations and the value and parent names of all
+	 * nodes, once their observation rows and values are set.
+	 */
+	void assignNames();
+
 	/**computeParentCombinations
 	 *
 	 * @param parents, a vector containing the node identifiers of the parents
@@ -56,27 +106,6 @@ class DataDistribution{
 	 */
 	void assignValueNames(Node& n);
 
-	/**getObservationColIndex
-	 *
-	 * @param sample, value of interest
-	 * @param n, A reference to a node
-	 *
-	 * @return The Index of the given value in the value list of the node
-	 *
-	 */
-	int getObservationColIndex(unsigned int sample, const Node& n);
-
-	/**getObservationRowIndex
-	 *
-	 * @param sample, 
-	 * @param n, A reference to a node
-	 * @param obsMatrix, A const reference to th observation matrix
-	 *
-	 * @return The index of the given value in the parent value list of the node
- 	 *
-	 */
-	int getObservationRowIndex(unsigned int sample, Node& n);
-
 	/**assignParentNames
 	 *
 	 * @param n, A reference to the node in question
@@ -89,16 +118,20 @@ class DataDistribution{
 
 	/**countObservations
 	 *
-	 * @param obsMatrix, A reference to a Matrix of typ int, containing the discretised observations
+	 * @param obsMatrix, A reference to the observation matrix of the node
 	 * @param n, A reference to a Node
 	 *
- 	 * This fills the observation matrix for a node, by iterating over the discretised samples
+ 	 * This adds the discretised samples to the observation matrix for a node.
+	 * Code is the type of the observation codes.
 	 */
-	void countObservations(Matrix<int>& obsMatrix, Node& n);
+	template <typename Code>
+	void countObservations(Table<int>& obsMatrix, Node& n);
 	// A reference to the network
 	Network& network_;	
-	// A reference to the observation matrix
-	Matrix<int>& observations_;
+	// Observations converted from a matrix of values
+	ObservationCodes convertedObservations_;
+	// A reference to the discretised observations
+	const ObservationCodes& observations_;
 	// A map from the original value names to the internal integer representation
 	std::unordered_map<std::string,int>& observationsMap_;
 	// A map from the internal integer representation (using the observationRow entry in the Node class) to the original string representation
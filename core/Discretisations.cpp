@@ -1,21 +1,66 @@
 #include "Discretisations.h"
-#include "sstream"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <limits>
 
 const int Discretisations::NA = -1;
 
-boost::optional<float> Discretisations::getNumber(const Observations& obs,
-                                                  unsigned int col,
-                                                  unsigned int row)
+const Discretisations::NumericRow&
+Discretisations::Data::getNumbers(unsigned int row)
 {
-	const auto& temp = obs(col, row);
-	if(temp == "NA") {
-		return boost::none;
+	if(!numbersRow_ || numbersRow_.get() != row) {
+		numbers_ = parseRow(input, row);
+		numbersRow_ = row;
+	}
+	return numbers_;
+}
+
+// Parses the leading number of value like a stream would
+float Discretisations::parseValue(const std::string& value)
+{
+	const char* first = value.data();
+	const char* last = value.data() + value.size();
+	while(first != last && std::isspace(static_cast<unsigned char>(*first))) {
+		++first;
+	}
+	if(first != last && *first == '+') {
+		++first;
+	}
+	float result = 0.0f;
+	if(std::from_chars(first, last, result).ec != std::errc()) {
+		return 0.0f;
+	}
+	return result;
+}
+
+Discretisations::NumericRow
+Discretisations::parseRow(const Observations& obs, unsigned int row)
+{
+	NumericRow numbers;
+	numbers.values.resize(obs.getColCount(), 0.0f);
+	numbers.na.resize(obs.getColCount());
+	for(unsigned int col = 0; col < obs.getColCount(); col++) {
+		const auto& value = obs(col, row);
+		if(value == "NA") {
+			numbers.na.set(col);
+		} else {
+			numbers.values[col] = parseValue(value);
+		}
+	}
+	return numbers;
+}
+
+void Discretisations::addValue(const std::string&) {}
+
+void Discretisations::nameValues(const std::vector<int>& values,
+                                 unsigned int row, ObservationMap& map,
+                                 RevObservationMap& revMap)
+{
+	for(auto value : values) {
+		createNameEntry(map, revMap, value, row);
 	}
-	std::stringstream ss(temp);
-	float f;
-	ss >> f;
-	return f;
-	//return std::stof(temp);
 }
 
 void Discretisations::createNameEntry(ObservationMap& obs,
@@ -27,51 +72,106 @@ void Discretisations::createNameEntry(ObservationMap& obs,
 	obsR[std::make_pair(value, row)] = svalue;
 }
 
-std::vector<float> Discretisations::createSortedVector(const Observations& obs,
-                                                       unsigned int row)
+std::vector<float>
+Discretisations::createValueVector(const NumericRow& numbers)
 {
 	std::vector<float> templist;
-	templist.reserve(obs.getColCount()-obs.countElement(1,row,"NA"));
-	for(unsigned int col = 0; col < obs.getColCount(); col++) {
-		auto value = getNumber(obs, col, row);
-		if(value) {
-			templist.push_back(value.get());
+	templist.reserve(numbers.size() - numbers.na.count());
+	for(unsigned int col = 0; col < numbers.size(); col++) {
+		if(!numbers.isNA(col)) {
+			templist.push_back(numbers.values[col]);
 		}
 	}
-	std::sort(templist.begin(), templist.end());
 	return templist;
 }
 
+namespace {
+// Places the elements of the sorted ranks [firstRank, lastRank) at their
+// sorted positions. offset is the rank of the element at begin.
+void selectRanks(std::vector<float>::iterator begin,
+                 std::vector<float>::iterator end, size_t offset,
+                 const size_t* firstRank, const size_t* lastRank)
+{
+	if(firstRank == lastRank) {
+		return;
+	}
+	const size_t* midRank = firstRank + (lastRank - firstRank) / 2;
+	auto nth = begin + (*midRank - offset);
+	std::nth_element(begin, nth, end);
+	selectRanks(begin, nth, offset, firstRank, midRank);
+	selectRanks(nth + 1, end, *midRank + 1, midRank + 1, lastRank);
+}
+}
+
+std::vector<float>
+Discretisations::selectOrderStatistics(std::vector<float>& values,
+                                       const std::vector<size_t>& ranks)
+{
+	std::vector<size_t> sortedRanks;
+	sortedRanks.reserve(ranks.size());
+	for(auto rank : ranks) {
+		if(rank < values.size()) {
+			sortedRanks.push_back(rank);
+		}
+	}
+	std::sort(sortedRanks.begin(), sortedRanks.end());
+	sortedRanks.erase(std::unique(sortedRanks.begin(), sortedRanks.end()),
+	                  sortedRanks.end());
+	selectRanks(values.begin(), values.end(), 0, sortedRanks.data(),
+	            sortedRanks.data() + sortedRanks.size());
+
+	std::vector<float> result;
+	result.reserve(ranks.size());
+	for(auto rank : ranks) {
+		result.push_back(rank < values.size()
+		                     ? values[rank]
+		                     : std::numeric_limits<float>::quiet_NaN());
+	}
+	return result;
+}
+
+int Discretisations::findBucket(const std::vector<float>& borders, float value)
+{
+	auto upper = std::upper_bound(borders.begin(), borders.end(), value);
+	if(upper == borders.begin() || upper == borders.end()) {
+		return NA;
+	}
+	return (upper - borders.begin()) - 1;
+}
+
 void Discretisations::convertToDenseNumbers(
     const std::vector<boost::optional<int>>& discretized, Data& data,
     unsigned int row)
 {
-	std::vector<boost::optional<int>> tmp(discretized);
-	std::sort(tmp.begin(), tmp.end(), [](const boost::optional<int>& a, const boost::optional<int>& b) {
-		if(a && b) {
-			return a.get() < b.get();
+	std::vector<int> uniqueValues;
+	uniqueValues.reserve(discretized.size());
+	for(const auto& value : discretized) {
+		if(value) {
+			uniqueValues.push_back(value.get());
 		}
-
-		return bool(a);
-	});
-
-	tmp.erase(std::unique(tmp.begin(), tmp.end()), tmp.end());
-	if(tmp.back() == boost::none) {
-		tmp.pop_back();
 	}
+	std::sort(uniqueValues.begin(), uniqueValues.end());
+	uniqueValues.erase(std::unique(uniqueValues.begin(), uniqueValues.end()),
+	                   uniqueValues.end());
 
+	bool hasNA = false;
 	for(unsigned int col = 0; col < data.input.getColCount(); ++col) {
 		int result = NA;
 		if(discretized[col]) {
-			for(size_t i = 0; i < tmp.size(); ++i) {
-				if(discretized[col] == tmp[i]) {
-					result = i;
-					break;
-				}
-			}
+			result = std::lower_bound(uniqueValues.begin(), uniqueValues.end(),
+			                          discretized[col].get()) -
+			         uniqueValues.begin();
+		} else {
+			hasNA = true;
 		}
+		data.setResult(result, col, row);
+	}
 
-		data.output.setData(result, col, row);
-		createNameEntry(data.map, data.revMap, result, row);
+	// One name entry per dense value instead of one per sample
+	for(int value = 0; value < static_cast<int>(uniqueValues.size()); ++value) {
+		createNameEntry(data.map, data.revMap, value, row);
+	}
+	if(hasNA) {
+		createNameEntry(data.map, data.revMap, NA, row);
 	}
 }
@@ -6,6 +6,7 @@
 #include <map>
 #include <unordered_map>
 
+#include <boost/dynamic_bitset.hpp>
 #include <boost/optional/optional.hpp>
 
 /**
@@ -21,18 +22,82 @@ class Discretisations
 
 	static const int NA;
 
+	/**
+	 * Numeric values of one row of the observations. NA entries are flagged
+	 * in the bitmap, their value is undefined.
+	 */
+	struct NumericRow
+	{
+		std::vector<float> values;
+		boost::dynamic_bitset<> na;
+
+		size_t size() const { return values.size(); }
+		bool isNA(unsigned int col) const { return na[col]; }
+	};
+
 	struct Data
 	{
 		Data(const Observations& input_, DiscObservations& output_,
 		     ObservationMap& map_, RevObservationMap& revMap_)
-		    : input(input_), output(output_), map(map_), revMap(revMap_)
+		    : input(input_),
+		      map(map_),
+		      revMap(revMap_),
+		      outputMatrix_(&output_),
+		      outputRow_(nullptr)
+		{
+		}
+
+		/**Data
+		 *
+		 * @param rowOutput_, receives the discretised values of the row
+		 * passed to apply, one per sample. Values that are not set by the
+		 * method keep their previous value.
+		 */
+		Data(const Observations& input_, std::vector<int>& rowOutput_,
+		     ObservationMap& map_, RevObservationMap& revMap_)
+		    : input(input_),
+		      map(map_),
+		      revMap(revMap_),
+		      outputMatrix_(nullptr),
+		      outputRow_(&rowOutput_)
+		{
+		}
+
+		/**setResult
+		 *
+		 * @param value, the discretised value
+		 * @param col, index of the sample
+		 * @param row, index of the row in the input matrix
+		 */
+		void setResult(int value, unsigned int col, unsigned int row)
 		{
+			if(outputRow_) {
+				(*outputRow_)[col] = value;
+			} else {
+				outputMatrix_->setData(value, col, row);
+			}
 		}
 
+		/**getNumbers
+		 *
+		 * @param row, index of the row in the input matrix
+		 *
+		 * @return the numeric values of the row. The row is parsed on the
+		 * first call only.
+		 */
+		const NumericRow& getNumbers(unsigned int row);
+
 		const Observations& input;
-		DiscObservations& output;
 		ObservationMap& map;
 		RevObservationMap& revMap;
+
+		private:
+		// Exactly one of the outputs is set
+		DiscObservations* outputMatrix_;
+		std::vector<int>* outputRow_;
+		// Index of the row stored in numbers_
+		boost::optional<unsigned int> numbersRow_;
+		NumericRow numbers_;
 	};
 
 	virtual ~Discretisations() = default;
@@ -48,15 +113,101 @@ class Discretisations
 	 **/
 	virtual void apply(unsigned int row, Data& data) = 0;
 
-	protected:
-	boost::optional<float> getNumber(const Observations& obs, unsigned int col,
-	                                 unsigned int row);
+	/**addValue
+	 *
+	 * @param value, the next value of a row, "NA" for a missing value
+	 *
+	 * First pass over a row that is streamed instead of held in memory:
+	 * collects the statistics the method needs. The memory used does not
+	 * grow with the number of samples, except for the distinct values kept
+	 * by methods that number them. By default no statistics are collected.
+	 */
+	virtual void addValue(const std::string& value);
 
+	/**finishValues
+	 *
+	 * Determines the discretisation of a streamed row from the statistics
+	 * collected by addValue.
+	 *
+	 * @return the largest value discretise can return
+	 */
+	virtual int finishValues() = 0;
+
+	/**discretise
+	 *
+	 * @param value, a value of a streamed row, "NA" for a missing value
+	 *
+	 * @return the discretised value, NA for a missing value. This is the
+	 * second pass over the row, after finishValues.
+	 */
+	virtual int discretise(const std::string& value) const = 0;
+
+	/**nameValues
+	 *
+	 * @param values, the sorted discretised values occurring in a streamed row
+	 * @param row, index of the row
+	 * @param map, receives the names of the values
+	 * @param revMap, receives the names of the values per row
+	 *
+	 * Creates the same names apply creates. By default, every value is named
+	 * by its number.
+	 */
+	virtual void nameValues(const std::vector<int>& values, unsigned int row,
+	                        ObservationMap& map, RevObservationMap& revMap);
+
+	/**parseRow
+	 *
+	 * @param obs, matrix containing the original data
+	 * @param row, index of the row to be parsed
+	 *
+	 * @return the numeric values of the row, "NA" entries are flagged
+	 */
+	static NumericRow parseRow(const Observations& obs, unsigned int row);
+
+	/**selectOrderStatistics
+	 *
+	 * @param values, values to select from, they are partially reordered
+	 * @param ranks, positions in the sorted order of the values
+	 *
+	 * @return the values at the given ranks of the sorted order, NaN for
+	 * ranks outside of the vector
+	 *
+	 * Performs a recursive multi-selection with nth_element, which is linear
+	 * in the number of values for a fixed number of ranks.
+	 */
+	static std::vector<float>
+	selectOrderStatistics(std::vector<float>& values,
+	                      const std::vector<size_t>& ranks);
+
+	/**findBucket
+	 *
+	 * @param borders, non-decreasing borders of the buckets
+	 * @param value, value to be assigned to a bucket
+	 *
+	 * @return index i such that borders[i] <= value < borders[i + 1], NA if
+	 * there is no such bucket
+	 */
+	static int findBucket(const std::vector<float>& borders, float value);
+
+	/**parseValue
+	 *
+	 * @param value, a value that is not "NA"
+	 *
+	 * @return the leading number of value, 0 if there is none
+	 */
+	static float parseValue(const std::string& value);
+
+	protected:
 	void createNameEntry(ObservationMap& obs, RevObservationMap& obsR,
 	                     int value, unsigned int row);
 
-	std::vector<float> createSortedVector(const Observations&,
-	                                      unsigned int row);
+	/**createValueVector
+	 *
+	 * @param numbers, numeric values of a row
+	 *
+	 * @return all values of the row that are not NA, in the original order
+	 */
+	std::vector<float> createValueVector(const NumericRow& numbers);
 
 	void
 	convertToDenseNumbers(const std::vector<boost::optional<int>>& discretized,
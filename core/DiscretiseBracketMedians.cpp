@@ -5,36 +5,58 @@ DiscretiseBracketMedians::DiscretiseBracketMedians(unsigned int buckets)
 {
 }
 
-void DiscretiseBracketMedians::apply(unsigned int row, Data& data)
+std::vector<size_t> DiscretiseBracketMedians::getRanks_(size_t count) const
 {
-	const auto& templist = createSortedVector(data.input, row);
-	std::vector<float> borderValues;
-	borderValues.reserve(buckets_ + 1);
-	// Calculate borders
-	borderValues.push_back(templist[0]);
+	// The minimum and every bucket-th order statistic
+	std::vector<size_t> ranks;
+	ranks.reserve(buckets_);
+	ranks.push_back(0);
 	for(unsigned int i = 1; i < buckets_; i++) {
-		float borderValue=templist[templist.size() / buckets_ * i];
-		borderValues.push_back(borderValue);
+		ranks.push_back(count / buckets_ * i);
 	}
+	return ranks;
+}
+
+void DiscretiseBracketMedians::apply(unsigned int row, Data& data)
+{
+	const auto& numbers = data.getNumbers(row);
+	std::vector<float> values = createValueVector(numbers);
+	// Calculate borders
+	std::vector<float> borderValues =
+	    selectOrderStatistics(values, getRanks_(values.size()));
 	borderValues.push_back(std::numeric_limits<float>::max());
 
 	// Fill intervals
 	for(unsigned int col = 0; col < data.input.getColCount(); col++) {
-		auto value = getNumber(data.input, col, row);
-
 		int result = NA;
 
-		if(value) {
-			for(unsigned int i = 1; i <= buckets_; i++) {
-				if(value.get() >= borderValues[i - 1] &&
-				   value.get() < borderValues[i]) {
-					result = i - 1;
-					break;
-				}
-			}
+		if(!numbers.isNA(col)) {
+			result = findBucket(borderValues, numbers.values[col]);
 		}
 
-		data.output.setData(result, col, row);
+		data.setResult(result, col, row);
 		createNameEntry(data.map, data.revMap, result, row);
 	}
 }
+
+void DiscretiseBracketMedians::addValue(const std::string& value)
+{
+	if(value != "NA") {
+		sketch_.add(parseValue(value));
+	}
+}
+
+int DiscretiseBracketMedians::finishValues()
+{
+	borders_ = sketch_.select(getRanks_(sketch_.size()));
+	borders_.push_back(std::numeric_limits<float>::max());
+	return static_cast<int>(borders_.size()) - 2;
+}
+
+int DiscretiseBracketMedians::discretise(const std::string& value) const
+{
+	if(value == "NA") {
+		return NA;
+	}
+	return findBucket(borders_, parseValue(value));
+}
@@ -2,6 +2,7 @@
 #define DISCRETISEBRACKETMEDIANS_H
 
 #include "Discretisations.h"
+#include "QuantileSketch.h"
 
 /**
  * DiscretiseBracketMedians
@@ -32,7 +33,30 @@ class DiscretiseBracketMedians : public Discretisations
 	 */
 	void apply(unsigned int row, Data& data) override;
 
+	void addValue(const std::string& value) override;
+
+	/**finishValues
+	 *
+	 * Calculates the borders of the buckets from a quantile sketch of the
+	 * row, which is exact up to the capacity of the sketch.
+	 *
+	 * @return the largest bucket
+	 */
+	int finishValues() override;
+
+	int discretise(const std::string& value) const override;
+
 	private:
+	/**getRanks_
+	 *
+	 * @param count, number of values of the row that are not NA
+	 *
+	 * @return the ranks of the lower borders of the buckets
+	 */
+	std::vector<size_t> getRanks_(size_t count) const;
+
 	unsigned int buckets_;
+	QuantileSketch sketch_;
+	std::vector<float> borders_;
 };
 #endif
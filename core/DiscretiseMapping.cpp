@@ -1,5 +1,7 @@
 #include "DiscretiseMapping.h"
 
+#include <algorithm>
+
 void DiscretiseMapping::apply(unsigned int row, Data& data)
 {
 	const auto& uniqueValues = data.input.getUniqueRowValues(row);
@@ -16,6 +18,40 @@ void DiscretiseMapping::apply(unsigned int row, Data& data)
 	}
 
 	for(unsigned int col = 0; col < data.input.getColCount(); col++) {
-		data.output.setData(data.map[data.input(col, row)], col, row);
+		data.setResult(data.map[data.input(col, row)], col, row);
+	}
+}
+
+void DiscretiseMapping::addValue(const std::string& value)
+{
+	if(value != "NA") {
+		uniqueValues_.insert(value);
+	}
+}
+
+int DiscretiseMapping::finishValues()
+{
+	names_.assign(uniqueValues_.begin(), uniqueValues_.end());
+	uniqueValues_.clear();
+	return static_cast<int>(names_.size()) - 1;
+}
+
+int DiscretiseMapping::discretise(const std::string& value) const
+{
+	if(value == "NA") {
+		return NA;
+	}
+	return std::lower_bound(names_.begin(), names_.end(), value) -
+	       names_.begin();
+}
+
+void DiscretiseMapping::nameValues(const std::vector<int>& values,
+                                   unsigned int row, ObservationMap& map,
+                                   RevObservationMap& revMap)
+{
+	for(auto value : values) {
+		const std::string& name = value == NA ? "NA" : names_[value];
+		map[name] = value;
+		revMap[std::make_pair(value, row)] = name;
 	}
 }
@@ -3,6 +3,8 @@
 
 #include "Discretisations.h"
 
+#include <set>
+
 /**
  * Maps already discrete values to a dense integer representation
  */
@@ -21,6 +23,33 @@ class DiscretiseMapping : public Discretisations
 	 *
 	 */
 	void apply(unsigned int row, Data& data) override;
+
+	/**addValue
+	 *
+	 * Collects the distinct values of the row, hence the memory grows with
+	 * the number of categories instead of the number of samples.
+	 */
+	void addValue(const std::string& value) override;
+
+	/**finishValues
+	 *
+	 * @return the number of distinct values other than NA minus one
+	 */
+	int finishValues() override;
+
+	int discretise(const std::string& value) const override;
+
+	/**nameValues
+	 *
+	 * Like apply, the values are named by the original values.
+	 */
+	void nameValues(const std::vector<int>& values, unsigned int row,
+	                ObservationMap& map, RevObservationMap& revMap) override;
+
+	private:
+	std::set<std::string> uniqueValues_;
+	// The sorted distinct values other than NA
+	std::vector<std::string> names_;
 };
 
 #endif
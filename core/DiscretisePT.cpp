@@ -1,30 +1,67 @@
 #include "DiscretisePT.h"
 
+std::vector<size_t> DiscretisePT::getRanks_(size_t count)
+{
+	// Constants are defined by the method
+	return {static_cast<size_t>(ceil(0.185 * count)) - 1,
+	        static_cast<size_t>(ceil(0.815 * count)) - 1};
+}
+
+std::vector<float> DiscretisePT::getBorders_(const std::vector<float>& quantiles)
+{
+	return {std::numeric_limits<float>::min(), quantiles[0], quantiles[1],
+	        std::numeric_limits<float>::max()};
+}
+
 void DiscretisePT::apply(unsigned int row, Data& data)
 {
-	const std::vector<float>& templist = createSortedVector(data.input, row);
-	const std::vector<float> borderValues = {
-	    // Calculate borders: Constants are defined by the method
-	    std::numeric_limits<float>::min(),
-	    templist[ceil(0.185 * templist.size())-1],
-	    templist[ceil(0.815 * templist.size())-1],
-	    std::numeric_limits<float>::max()};
+	const auto& numbers = data.getNumbers(row);
+	std::vector<float> values = createValueVector(numbers);
+	// Calculate borders
+	const std::vector<float> borderValues = getBorders_(
+	    selectOrderStatistics(values, getRanks_(values.size())));
 	// Fill intervals
 	for(unsigned int col = 0; col < data.input.getColCount(); col++) {
-		auto value = getNumber(data.input, col, row);
-
-		if(!value) {
-			data.output.setData(NA, col, row);
+		if(numbers.isNA(col)) {
+			data.setResult(NA, col, row);
 			continue;
 		}
 
-		for(int i = 1; i < 4; i++) {
-			if(value.get() >= borderValues[i - 1] &&
-			   value.get() < borderValues[i]) {
-				data.output.setData(i - 1, col, row);
-				createNameEntry(data.map, data.revMap, i - 1, row);
-				break;
-			}
+		const int result = findBucket(borderValues, numbers.values[col]);
+		if(result != NA) {
+			data.setResult(result, col, row);
+			createNameEntry(data.map, data.revMap, result, row);
+		}
+	}
+}
+
+void DiscretisePT::addValue(const std::string& value)
+{
+	if(value != "NA") {
+		sketch_.add(parseValue(value));
+	}
+}
+
+int DiscretisePT::finishValues()
+{
+	borders_ = getBorders_(sketch_.select(getRanks_(sketch_.size())));
+	return static_cast<int>(borders_.size()) - 2;
+}
+
+int DiscretisePT::discretise(const std::string& value) const
+{
+	if(value == "NA") {
+		return NA;
+	}
+	return findBucket(borders_, parseValue(value));
+}
+
+void DiscretisePT::nameValues(const std::vector<int>& values, unsigned int row,
+                              ObservationMap& map, RevObservationMap& revMap)
+{
+	for(auto value : values) {
+		if(value != NA) {
+			createNameEntry(map, revMap, value, row);
 		}
 	}
 }
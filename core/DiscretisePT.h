@@ -2,6 +2,7 @@
 #define DISCRETISEPT_H
 
 #include "Discretisations.h"
+#include "QuantileSketch.h"
 
 /**
  * DiscretisePT
@@ -22,5 +23,45 @@ class DiscretisePT : public Discretisations
 	 * given row in the given data
 	 */
 	void apply(unsigned int row, Data& data) override;
+
+	void addValue(const std::string& value) override;
+
+	/**finishValues
+	 *
+	 * Calculates the borders from a quantile sketch of the row, which is
+	 * exact up to the capacity of the sketch.
+	 *
+	 * @return the largest bucket
+	 */
+	int finishValues() override;
+
+	int discretise(const std::string& value) const override;
+
+	/**nameValues
+	 *
+	 * Like apply, names all values except NA.
+	 */
+	void nameValues(const std::vector<int>& values, unsigned int row,
+	                ObservationMap& map, RevObservationMap& revMap) override;
+
+	private:
+	/**getRanks_
+	 *
+	 * @param count, number of values of the row that are not NA
+	 *
+	 * @return the ranks of the quantiles defined by the method
+	 */
+	static std::vector<size_t> getRanks_(size_t count);
+
+	/**getBorders_
+	 *
+	 * @param quantiles, the values at the ranks of getRanks_
+	 *
+	 * @return the borders of the buckets
+	 */
+	static std::vector<float> getBorders_(const std::vector<float>& quantiles);
+
+	QuantileSketch sketch_;
+	std::vector<float> borders_;
 };
 #endif
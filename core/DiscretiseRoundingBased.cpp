@@ -1,7 +1,53 @@
 #include "DiscretiseRoundingBased.h"
 
+#include <algorithm>
 #include <cmath>
 
+DiscretiseRoundingBased::DiscretiseRoundingBased(float (*func)(float))
+    : func_(func)
+{
+}
+
+void DiscretiseRoundingBased::addValue(const std::string& value)
+{
+	if(value != "NA") {
+		uniqueValues_.insert(static_cast<int>(func_(parseValue(value))));
+	}
+}
+
+int DiscretiseRoundingBased::finishValues()
+{
+	denseValues_.assign(uniqueValues_.begin(), uniqueValues_.end());
+	uniqueValues_.clear();
+	return static_cast<int>(denseValues_.size()) - 1;
+}
+
+int DiscretiseRoundingBased::discretise(const std::string& value) const
+{
+	if(value == "NA") {
+		return NA;
+	}
+	const int rounded = static_cast<int>(func_(parseValue(value)));
+	return std::lower_bound(denseValues_.begin(), denseValues_.end(),
+	                        rounded) -
+	       denseValues_.begin();
+}
+
+DiscretiseRound::DiscretiseRound()
+    : DiscretiseRoundingBased(static_cast<float (*)(float)>(std::round))
+{
+}
+
+DiscretiseCeil::DiscretiseCeil()
+    : DiscretiseRoundingBased(static_cast<float (*)(float)>(std::ceil))
+{
+}
+
+DiscretiseFloor::DiscretiseFloor()
+    : DiscretiseRoundingBased(static_cast<float (*)(float)>(std::floor))
+{
+}
+
 void DiscretiseRound::apply(unsigned int row, Data& data)
 {
 	DiscretiseRoundingBased::apply(row, data,
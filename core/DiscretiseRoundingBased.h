@@ -3,12 +3,37 @@
 
 #include "Discretisations.h"
 
+#include <set>
+
 /**
  * Base class of rounding-based discretisation methods.
  */
 class DiscretiseRoundingBased : public Discretisations
 {
+	public:
+	/**addValue
+	 *
+	 * Collects the distinct rounded values of the row, hence the memory
+	 * grows with the number of distinct values instead of the number of
+	 * samples.
+	 */
+	void addValue(const std::string& value) override;
+
+	/**finishValues
+	 *
+	 * @return the number of distinct rounded values minus one
+	 */
+	int finishValues() override;
+
+	int discretise(const std::string& value) const override;
+
 	protected:
+	/**DiscretiseRoundingBased
+	 *
+	 * @param func the rounding function used for streamed rows
+	 */
+	explicit DiscretiseRoundingBased(float (*func)(float));
+
 	/**apply
 	 *
 	 * @param row index of the row that should be
@@ -23,19 +48,24 @@ class DiscretiseRoundingBased : public Discretisations
 	void apply(unsigned int row, Data& data, const T& func)
 	{
 
-		std::vector<boost::optional<int>> discretised(data.input.getColCount(),
+		const auto& numbers = data.getNumbers(row);
+		std::vector<boost::optional<int>> discretised(numbers.size(),
 		                                              boost::none);
 
-		for(unsigned int col = 0; col < data.input.getColCount(); col++) {
-			auto value = getNumber(data.input, col, row);
-
-			if(value) {
-				discretised[col] = func(value.get());
+		for(unsigned int col = 0; col < numbers.size(); col++) {
+			if(!numbers.isNA(col)) {
+				discretised[col] = func(numbers.values[col]);
 			}
 		}
 
 		convertToDenseNumbers(discretised, data, row);
 	}
+
+	private:
+	float (*func_)(float);
+	std::set<int> uniqueValues_;
+	// The sorted distinct rounded values, their indices are the dense values
+	std::vector<int> denseValues_;
 };
 
 /**
@@ -44,6 +74,8 @@ class DiscretiseRoundingBased : public Discretisations
 class DiscretiseRound : public DiscretiseRoundingBased
 {
 	public:
+	DiscretiseRound();
+
 	/**apply
 	 *
 	 * @param row index of the row that should be
@@ -64,6 +96,8 @@ class DiscretiseRound : public DiscretiseRoundingBased
 class DiscretiseCeil : public DiscretiseRoundingBased
 {
 	public:
+	DiscretiseCeil();
+
 	/**apply
 	 *
 	 * @param row index of the row that should be
@@ -83,6 +117,8 @@ class DiscretiseCeil : public DiscretiseRoundingBased
 class DiscretiseFloor : public DiscretiseRoundingBased
 {
 	public:
+	DiscretiseFloor();
+
 	/**apply
 	 *
 	 * @param row index of the row that should be
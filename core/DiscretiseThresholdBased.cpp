@@ -6,43 +6,80 @@ void DiscretiseThresholdBased::apply_(unsigned int row,
                                       Discretisations::Data& data,
                                       float threshold)
 {
-	for(unsigned int col = 0; col < data.input.getColCount(); col++) {
+	const auto& numbers = data.getNumbers(row);
+	for(unsigned int col = 0; col < numbers.size(); col++) {
 		int result = NA;
 
-		auto value = getNumber(data.input, col, row);
-		if(value) {
-			result = (value.get() > threshold) ? 1 : 0;
+		if(!numbers.isNA(col)) {
+			result = (numbers.values[col] > threshold) ? 1 : 0;
 		}
 
-		data.output.setData(result, col, row);
+		data.setResult(result, col, row);
 		createNameEntry(data.map, data.revMap, result, row);
 	}
 }
 
-void DiscretiseMedian::apply(unsigned int row, Data& data)
+int DiscretiseThresholdBased::finishValues() { return 1; }
+
+int DiscretiseThresholdBased::discretise(const std::string& value) const
+{
+	if(value == "NA") {
+		return NA;
+	}
+	return (parseValue(value) > threshold_) ? 1 : 0;
+}
+
+namespace
+{
+// Ranks of the middle values of count values, the median is their mean
+std::vector<size_t> getMedianRanks(size_t count)
+{
+	const size_t half = count / 2;
+	if(count % 2 != 0) {
+		return {half};
+	}
+	return {half - 1, half};
+}
+
+float getMedian(const std::vector<float>& middle)
 {
-	const std::vector<float>& templist = createSortedVector(data.input, row);
-	float median;
-	if(templist.size() % 2 != 0) {
-		median = templist[std::ceil(templist.size() / 2)];
-	} else {
-		median = (templist[(templist.size() / 2) - 1] +
-		          templist[templist.size() / 2]) /
-		         2.0f;
+	if(middle.size() == 1) {
+		return middle[0];
 	}
+	return (middle[0] + middle[1]) / 2.0f;
+}
+}
+
+void DiscretiseMedian::apply(unsigned int row, Data& data)
+{
+	std::vector<float> values = createValueVector(data.getNumbers(row));
+	const float median = getMedian(
+	    selectOrderStatistics(values, getMedianRanks(values.size())));
 
 	apply_(row, data, median);
 }
 
+void DiscretiseMedian::addValue(const std::string& value)
+{
+	if(value != "NA") {
+		sketch_.add(parseValue(value));
+	}
+}
+
+int DiscretiseMedian::finishValues()
+{
+	threshold_ = getMedian(sketch_.select(getMedianRanks(sketch_.size())));
+	return DiscretiseThresholdBased::finishValues();
+}
+
 void DiscretiseArithmeticMean::apply(unsigned int row, Data& data)
 {
+	const auto& numbers = data.getNumbers(row);
 	float mean = 0;
 	unsigned int count = 0;
-	for(unsigned int col = 0; col < data.input.getColCount(); col++) {
-		auto value = getNumber(data.input, col, row);
-
-		if(value) {
-			mean += value.get();
+	for(unsigned int col = 0; col < numbers.size(); col++) {
+		if(!numbers.isNA(col)) {
+			mean += numbers.values[col];
 			++count;
 		}
 	}
@@ -50,15 +87,28 @@ void DiscretiseArithmeticMean::apply(unsigned int row, Data& data)
 	apply_(row, data, mean / count);
 }
 
+void DiscretiseArithmeticMean::addValue(const std::string& value)
+{
+	if(value != "NA") {
+		sum_ += parseValue(value);
+		++count_;
+	}
+}
+
+int DiscretiseArithmeticMean::finishValues()
+{
+	threshold_ = sum_ / count_;
+	return DiscretiseThresholdBased::finishValues();
+}
+
 void DiscretiseHarmonicMean::apply(unsigned int row, Data& data)
 {
+	const auto& numbers = data.getNumbers(row);
 	float mean = 0;
 	unsigned int count = 0;
-	for(unsigned int col = 0; col < data.input.getColCount(); col++) {
-		auto value = getNumber(data.input, col, row);
-
-		if(value) {
-			mean += 1.0f / value.get();
+	for(unsigned int col = 0; col < numbers.size(); col++) {
+		if(!numbers.isNA(col)) {
+			mean += 1.0f / numbers.values[col];
 			++count;
 		}
 	}
@@ -66,9 +116,23 @@ void DiscretiseHarmonicMean::apply(unsigned int row, Data& data)
 	apply_(row, data, count / mean);
 }
 
+void DiscretiseHarmonicMean::addValue(const std::string& value)
+{
+	if(value != "NA") {
+		sum_ += 1.0f / parseValue(value);
+		++count_;
+	}
+}
+
+int DiscretiseHarmonicMean::finishValues()
+{
+	threshold_ = count_ / sum_;
+	return DiscretiseThresholdBased::finishValues();
+}
+
 DiscretiseThreshold::DiscretiseThreshold(float threshold)
-    : threshold_(threshold)
 {
+	threshold_ = threshold;
 }
 
 void DiscretiseThreshold::apply(unsigned int row, Data& data)
@@ -2,6 +2,7 @@
 #define DISCRETISETHRESHOLDBASED_H
 
 #include "Discretisations.h"
+#include "QuantileSketch.h"
 
 /**
  * DiscretiseThresholdBased
@@ -10,6 +11,15 @@
  **/
 class DiscretiseThresholdBased : public Discretisations
 {
+	public:
+	/**finishValues
+	 *
+	 * @return 1, the value of the samples above the threshold
+	 */
+	int finishValues() override;
+
+	int discretise(const std::string& value) const override;
+
 	protected:
 	/**apply
 	 *
@@ -26,6 +36,9 @@ class DiscretiseThresholdBased : public Discretisations
 	 * given row in the given data
 	 */
 	void apply_(unsigned int row, Data& data, float threshold);
+
+	// Threshold of streamed rows
+	float threshold_ = 0.0f;
 };
 
 /**
@@ -46,6 +59,20 @@ class DiscretiseMedian : public DiscretiseThresholdBased
 	 * Divides the data according to its median 
 	 */	
 	void apply(unsigned int row, Data& data) override;
+
+	void addValue(const std::string& value) override;
+
+	/**finishValues
+	 *
+	 * Takes the median from a quantile sketch of the row, which is exact up
+	 * to the capacity of the sketch.
+	 *
+	 * @return 1, the value of the samples above the median
+	 */
+	int finishValues() override;
+
+	private:
+	QuantileSketch sketch_;
 };
 
 /**
@@ -67,6 +94,14 @@ class DiscretiseArithmeticMean : public DiscretiseThresholdBased
 	 * mean 
 	 */
 	void apply(unsigned int row, Data& data) override;
+
+	void addValue(const std::string& value) override;
+
+	int finishValues() override;
+
+	private:
+	float sum_ = 0.0f;
+	unsigned int count_ = 0;
 };
 
 /**
@@ -88,6 +123,14 @@ class DiscretiseHarmonicMean : public DiscretiseThresholdBased
 	 * mean 
 	 */
 	void apply(unsigned int row, Data& data) override;
+
+	void addValue(const std::string& value) override;
+
+	int finishValues() override;
+
+	private:
+	float sum_ = 0.0f;
+	unsigned int count_ = 0;
 };
 
 /**
@@ -112,9 +155,6 @@ class DiscretiseThreshold : public DiscretiseThresholdBased
 	 * threshold
 	 */
 	void apply(unsigned int row, Data& data) override;
-
-	private:
-	float threshold_;
 };
 
 #endif // DISCRETISETHRESHOLDBASED_H
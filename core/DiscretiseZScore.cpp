@@ -2,15 +2,15 @@
 
 void DiscretiseZScore::apply(unsigned int row, Data& data)
 {
-
+	const auto& numbers = data.getNumbers(row);
 	unsigned int count = 0;
 	float expValue = 0.0f;
 	float expValue2 = 0.0f;
-	for(unsigned int col = 0; col < data.input.getColCount(); col++) {
-		auto value = getNumber(data.input, col, row);
-		if(value) {
-			expValue += value.get();
-			expValue2 += (value.get() * value.get());
+	for(unsigned int col = 0; col < numbers.size(); col++) {
+		if(!numbers.isNA(col)) {
+			const float value = numbers.values[col];
+			expValue += value;
+			expValue2 += (value * value);
 			++count;
 		}
 	}
@@ -18,14 +18,44 @@ void DiscretiseZScore::apply(unsigned int row, Data& data)
 	expValue2 = expValue2 / count;
 
 	float standardDeviation = sqrt(expValue2 - (expValue * expValue));
-	for(unsigned int col = 0; col < data.input.getColCount(); col++) {
-		auto value = getNumber(data.input, col, row);
-
+	for(unsigned int col = 0; col < numbers.size(); col++) {
 		int result = NA;
-		if(value) {
-			float z = std::abs((value.get() - expValue) / standardDeviation);
+		if(!numbers.isNA(col)) {
+			float z = std::abs((numbers.values[col] - expValue) / standardDeviation);
 			result = (z > 2.0f) ? 1 : 0;
 		}
-		data.output.setData(result, col, row);
+		data.setResult(result, col, row);
+	}
+}
+
+void DiscretiseZScore::addValue(const std::string& value)
+{
+	if(value != "NA") {
+		const float number = parseValue(value);
+		expValue_ += number;
+		expValue2_ += (number * number);
+		++count_;
+	}
+}
+
+int DiscretiseZScore::finishValues()
+{
+	expValue_ = expValue_ / count_;
+	expValue2_ = expValue2_ / count_;
+	standardDeviation_ = sqrt(expValue2_ - (expValue_ * expValue_));
+	return 1;
+}
+
+int DiscretiseZScore::discretise(const std::string& value) const
+{
+	if(value == "NA") {
+		return NA;
 	}
+	float z = std::abs((parseValue(value) - expValue_) / standardDeviation_);
+	return (z > 2.0f) ? 1 : 0;
+}
+
+void DiscretiseZScore::nameValues(const std::vector<int>&, unsigned int,
+                                  ObservationMap&, RevObservationMap&)
+{
 }
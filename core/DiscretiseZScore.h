@@ -21,5 +21,30 @@ class DiscretiseZScore : public Discretisations
 	 * Divides the data according to its Z-Score
 	 */
 	void apply(unsigned int row, Data& data) override;
+
+	void addValue(const std::string& value) override;
+
+	/**finishValues
+	 *
+	 * Calculates mean and standard deviation of the row.
+	 *
+	 * @return 1, the value of outliers
+	 */
+	int finishValues() override;
+
+	int discretise(const std::string& value) const override;
+
+	/**nameValues
+	 *
+	 * Like apply, no names are created.
+	 */
+	void nameValues(const std::vector<int>& values, unsigned int row,
+	                ObservationMap& map, RevObservationMap& revMap) override;
+
+	private:
+	unsigned int count_ = 0;
+	float expValue_ = 0.0f;
+	float expValue2_ = 0.0f;
+	float standardDeviation_ = 0.0f;
 };
 #endif
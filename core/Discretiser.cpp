@@ -1,33 +1,90 @@
 #include "Discretiser.h"
 #include "DiscretisationFactory.h"
+#include "Trace.h"
 #include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
 #include "math.h"
 
+namespace
+{
+// Calls f for every row, distributing the rows among the available cores
+template <typename Function>
+void forEachRow(unsigned int rowCount, Function f)
+{
+	std::atomic<unsigned int> nextRow(0);
+	const unsigned int threadCount =
+	    std::min(std::max(std::thread::hardware_concurrency(), 1u), rowCount);
+	std::vector<std::exception_ptr> errors(threadCount);
+	auto worker = [&](unsigned int thread) {
+		try {
+			for(unsigned int row = nextRow++; row < rowCount; row = nextRow++) {
+				f(row);
+			}
+		} catch(...) {
+			errors[thread] = std::current_exception();
+			// Let the other threads run out of rows
+			nextRow = rowCount;
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount);
+	for(unsigned int i = 1; i < threadCount; i++) {
+		threads.emplace_back(worker, i);
+	}
+	if(threadCount > 0) {
+		worker(0);
+	}
+	for(auto& thread : threads) {
+		thread.join();
+	}
+	for(const auto& error : errors) {
+		if(error) {
+			std::rethrow_exception(error);
+		}
+	}
+}
+}
+
 Discretiser::Discretiser(const Matrix<std::string>& originalObservations,
                          Matrix<int>& obsMatrix, Network& network)
     : originalObservations_(originalObservations),
-      observations_(obsMatrix),
+      observations_(&obsMatrix),
+      codes_(nullptr),
       network_(network)
 {
 	adaptFormat();
-	observations_.resize(originalObservations.getColCount(),
-	                     originalObservations.getRowCount(), -1);
-	observations_.setRowNames(originalObservations.getRowNames());
-	observations_.setColNames(originalObservations.getColNames());
+	observations_->resize(originalObservations.getColCount(),
+	                      originalObservations.getRowCount(), -1);
+	observations_->setRowNames(originalObservations.getRowNames());
+	observations_->setColNames(originalObservations.getColNames());
 }
 
 Discretiser::Discretiser(const Matrix<std::string>& originalObservations,
                          const std::string& filename, Matrix<int>& obsMatrix,
                          Network& network)
-    : originalObservations_(originalObservations),
-      observations_(obsMatrix),
+    : Discretiser(originalObservations, obsMatrix, network)
+{
+	discretise(filename);
+}
+
+Discretiser::Discretiser(Matrix<std::string>&& originalObservations,
+                         ObservationCodes& codes, Network& network)
+    : originalObservations_(std::move(originalObservations)),
+      observations_(nullptr),
+      codes_(&codes),
       network_(network)
 {
 	adaptFormat();
-	observations_.resize(originalObservations.getColCount(),
-	                     originalObservations.getRowCount(), -1);
-	observations_.setRowNames(originalObservations.getRowNames());
-	observations_.setColNames(originalObservations.getColNames());
+}
+
+Discretiser::Discretiser(Matrix<std::string>&& originalObservations,
+                         const std::string& filename, ObservationCodes& codes,
+                         Network& network)
+    : Discretiser(std::move(originalObservations), codes, network)
+{
 	discretise(filename);
 }
 
@@ -45,26 +102,81 @@ void Discretiser::discretise(const std::string& controlFile)
 
 void Discretiser::discretise()
 {
-
+	CT_TRACE_SCOPE("Discretiser::discretise");
 	DiscretisationFactory dF(jsonTree_);
+	// Matrices may have fewer row names than rows
+	std::vector<std::string> rowNames = originalObservations_.getRowNames();
+	rowNames.resize(originalObservations_.getRowCount());
 	// Create Discretisations Objects
-	for(unsigned int i = 0; i < observations_.getRowCount(); i++) {
-		discretisations_.push_back(dF.create(observations_.getRowNames()[i]));
+	discretisations_.clear();
+	for(const auto& name : rowNames) {
+		discretisations_.push_back(dF.create(name));
 	}
 	
-	Discretisations::Data data(originalObservations_, observations_,
-	                           network_.getObservationsMap(),
-	                           network_.getObservationsMapR());
-
-	// Apply Discretisation;
-	unsigned int row = 0;
-	for(auto& ptr : discretisations_) {
-		ptr->apply(row, data);
-		++row;
+	// The rows are discretised in parallel. Each row writes its value names
+	// into local maps, which are merged into the network afterwards.
+	const unsigned int rowCount = discretisations_.size();
+	const unsigned int colCount = originalObservations_.getColCount();
+	std::vector<Discretisations::ObservationMap> maps(rowCount);
+	std::vector<Discretisations::RevObservationMap> revMaps(rowCount);
+	if(!codes_) {
+		forEachRow(rowCount, [&](unsigned int row) {
+			Discretisations::Data data(originalObservations_, *observations_,
+			                           maps[row], revMaps[row]);
+			discretisations_[row]->apply(row, data);
+		});
+	} else {
+		// The width of the codes is chosen from the bounds of the values the
+		// rows can take, such that the codes are allocated once and every row
+		// is written into them as soon as it is discretised
+		std::vector<int> maxValues(rowCount);
+		forEachRow(rowCount, [&](unsigned int row) {
+			auto bound = dF.create(rowNames[row]);
+			for(unsigned int col = 0; col < colCount; col++) {
+				bound->addValue(originalObservations_(col, row));
+			}
+			maxValues[row] = bound->finishValues();
+		});
+		*codes_ = ObservationCodes(
+		    colCount, rowNames,
+		    maxValues.empty()
+		        ? Discretisations::NA
+		        : *std::max_element(maxValues.begin(), maxValues.end()));
+		codes_->setColNames(originalObservations_.getColNames());
+		forEachRow(rowCount, [&](unsigned int row) {
+			std::vector<int> values(colCount, Discretisations::NA);
+			Discretisations::Data data(originalObservations_, values, maps[row],
+			                           revMaps[row]);
+			discretisations_[row]->apply(row, data);
+			codes_->setRow(row, values);
+		});
+	}
+
+	// Merge in row order, such that the result equals a sequential run
+	auto& observationsMap = network_.getObservationsMap();
+	auto& observationsMapR = network_.getObservationsMapR();
+	for(unsigned int row = 0; row < rowCount; row++) {
+		for(auto& entry : maps[row]) {
+			observationsMap[entry.first] = entry.second;
+		}
+		for(auto& entry : revMaps[row]) {
+			observationsMapR[entry.first] = std::move(entry.second);
+		}
 	}
 }
 
-void Discretiser::adaptFormat()
+void Discretiser::adaptFormat() { adaptFormat(originalObservations_); }
+
+void Discretiser::adaptFormat(Matrix<std::string>& observations)
+{
+	for(unsigned int col = 0; col < observations.getColCount(); col++) {
+		for(unsigned int row = 0; row < observations.getRowCount(); row++) {
+			adaptFormat(observations(col, row));
+		}
+	}
+}
+
+void Discretiser::adaptFormat(std::string& value)
 {
 	static const std::string na1 = "na";
 	static const std::string na2 = "-";
@@ -72,14 +184,7 @@ void Discretiser::adaptFormat()
 
 	static const std::string canonical_na("NA");
 
-	for(unsigned int col = 0; col < originalObservations_.getColCount();
-	    col++) {
-		for(unsigned int row = 0; row < originalObservations_.getRowCount();
-		    row++) {
-			std::string& value = originalObservations_(col, row);
-			if(value == na1 || value == na2 || value == na3) {
-				value = canonical_na;
-			}
-		}
+	if(value == na1 || value == na2 || value == na3) {
+		value = canonical_na;
 	}
 }
@@ -4,6 +4,7 @@
 #include "Discretisations.h"
 #include "DiscretisationSettings.h"
 #include "Network.h"
+#include "ObservationCodes.h"
 #include "float.h"
 #include <map>
 
@@ -43,6 +44,37 @@ class Discretiser
 	            const std::string& filename, Matrix<int>& obsMatrix,
 	            Network& network);
 
+	/**Discretiser
+	 *
+	 * @param originalObservations, the matrix containing the raw sample data,
+	 * which is taken over instead of copied
+	 * @param codes, receives the discretised data. The rows are discretised
+	 * into narrow codes one at a time, such that no matrix of discretised
+	 * values is needed.
+	 * @param network, a reference to the network
+	 *
+	 * @return Discretiser Object
+	 */
+	Discretiser(Matrix<std::string>&& originalObservations,
+	            ObservationCodes& codes, Network& network);
+
+	/**Discretiser
+	 *
+	 * @param originalObservations, the matrix containing the raw sample data,
+	 * which is taken over instead of copied
+	 * @param filename, name of a "controlFile" that regulates the
+	 * discretisation for each node
+	 * @param codes, receives the discretised data
+	 * @param network, a reference to the network
+	 *
+	 * @return Discretiser Object
+	 *
+	 * Discretises all observations listed in the controlFile into codes.
+	 */
+	Discretiser(Matrix<std::string>&& originalObservations,
+	            const std::string& filename, ObservationCodes& codes,
+	            Network& network);
+
 	/**setJsonTree
 	 *
 	 * @param A reference to a DiscretisationSettings Object
@@ -72,6 +104,22 @@ class Discretiser
 	 */
 	void discretise();
 
+	/**adaptFormat
+	 *
+	 * @param observations, raw sample data
+	 *
+	 * Replaces various kinds of NA representations by a unique version
+	 */
+	static void adaptFormat(Matrix<std::string>& observations);
+
+	/**adaptFormat
+	 *
+	 * @param value, a raw value
+	 *
+	 * Replaces various kinds of NA representations by a unique version
+	 */
+	static void adaptFormat(std::string& value);
+
 	private:
 	/**createDiscretisaionClasses
 	 *
@@ -86,12 +134,15 @@ class Discretiser
 	 * Replaces various kinds of NA representations by a unqiue version
 	 */
 	void adaptFormat();
+
 	// Json Tree
 	DiscretisationSettings jsonTree_;
 	// Matrix containing the original raw sample data
 	Matrix<std::string> originalObservations_;
-	// Matrix containing the discretised data
-	Matrix<int>& observations_;
+	// Matrix containing the discretised data, if discretised into a matrix
+	Matrix<int>* observations_;
+	// The discretised data, if discretised into codes
+	ObservationCodes* codes_;
 	// Vector of unique pointers, pointing to discretisation objects
 	std::vector<std::unique_ptr<Discretisations>> discretisations_;
 	// Network
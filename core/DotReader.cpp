@@ -1,5 +1,9 @@
 #include "DotReader.h"
 
+#include <algorithm>
+#include <iostream>
+#include <unordered_set>
+
 #include <boost/phoenix/phoenix.hpp>
 
 #define BOOST_SPIRIT_USE_PHOENIX_V3
@@ -92,19 +96,20 @@ struct DotGrammar : qi::grammar<Iterator, Graph(), ascii::space_type>
 			| qi::lit("digraph")[qi::_val = true]
 			;
 
-		stmt_list = (stmt(qi::_r1) % ';') >> -qi::lit(';');
+		// Semicolons between statements are optional
+		stmt_list = *(stmt(qi::_r1) >> -qi::lit(';'));
 
 		stmt
 			= attr_stmt(qi::_r1)
 			| edge_stmt[
 				phx::insert(
 					phx::bind(&Graph::edges, qi::_r1),
-					phx::begin(phx::bind(&Graph::edges, qi::_r1)),
+					phx::end(phx::bind(&Graph::edges, qi::_r1)),
 					phx::begin(qi::_1),
 					phx::end(qi::_1)
 				)]
-			| node_stmt[phx::push_back(phx::bind(&Graph::nodes, qi::_r1), qi::_1)]
 			| assign //TODO: Do something with this
+			| node_stmt[phx::push_back(phx::bind(&Graph::nodes, qi::_r1), qi::_1)]
 			;
 
 		attr_stmt
@@ -132,14 +137,16 @@ struct DotGrammar : qi::grammar<Iterator, Graph(), ascii::space_type>
 			;
 
 		// Auxillary rules
+		// Identifiers must not span whitespace, as statements need not be
+		// separated by semicolons
 		id
-			= qi::char_("a-zA-Z_\200-\377") >> *qi::char_("a-zA-Z_\200-\3770-9")
+			= qi::lexeme[qi::char_("a-zA-Z_\200-\377") >> *qi::char_("a-zA-Z_\200-\3770-9")]
 			| qi::lexeme['"' >> *(qi::char_ - '"') >> '"']
-			| -qi::char_('-') >>
+			| qi::lexeme[-qi::char_('-') >>
 				(
 					(qi::char_('.') >> +qi::char_("0-9")) |
 					(+qi::char_("0-9") >> -(qi::char_('.') >> *qi::char_("0-9")))
-				)
+				)]
 			;
 
 		assign = id >> qi::lit('=') >> id;
@@ -162,6 +169,110 @@ struct DotGrammar : qi::grammar<Iterator, Graph(), ascii::space_type>
 	qi::rule<Iterator, ascii::space_type> edge_op;
 };
 
+/**
+ * The grammar above without attributes. Identifiers are passed to the
+ * callbacks as ranges of the input, such that nothing is materialised.
+ */
+struct DotStructureGrammar : qi::grammar<const char*, ascii::space_type>
+{
+	using Iterator = const char*;
+	using Range = boost::iterator_range<Iterator>;
+
+	DotStructureGrammar(bool& isDirected, const Reader::NodeCallback& onNode,
+	                    const Reader::EdgeCallback& onEdge)
+		: DotStructureGrammar::base_type(graph), onNode_(onNode), onEdge_(onEdge)
+	{
+		graph
+			=  -qi::lit("strict")
+			>> directed          [phx::ref(isDirected) = qi::_1]
+			>> -id
+			>> '{'
+			>> stmt_list
+			>> '}';
+
+		directed
+			= qi::lit("graph")  [qi::_val = false]
+			| qi::lit("digraph")[qi::_val = true]
+			;
+
+		stmt_list = *(stmt >> -qi::lit(';'));
+
+		stmt = attr_stmt | edge_stmt | assign | node_stmt;
+
+		attr_stmt = (qi::lit("graph") | qi::lit("node") | qi::lit("edge")) >> attr_list;
+
+		attr_list = '[' >> -(assign % qi::char_(";,")) >> ']';
+
+		// The local holds the previous node of the edge chain
+		edge_stmt
+			=  node_id[qi::_a = qi::_1]
+			>> +(edge_op >> node_id[
+				phx::bind(&DotStructureGrammar::edge_, this, qi::_a, qi::_1),
+				qi::_a = qi::_1
+			])
+			>> -attr_list;
+		edge_op = qi::lit("--") | qi::lit("->");
+
+		node_stmt = node_id[phx::bind(&DotStructureGrammar::node_, this, qi::_1)] >> -attr_list;
+		node_id = id[qi::_val = qi::_1] >> -(':' >> id >> -(':' >> compass_pt));
+
+		compass_pt
+			= qi::lit("ne") | qi::lit("nw") | qi::lit("se")
+			| qi::lit("sw") | qi::lit("n")  | qi::lit("s")
+			| qi::lit("w")  | qi::lit("e")  | qi::lit("c") | qi::lit("_")
+			;
+
+		id
+			= qi::raw[qi::lexeme[qi::char_("a-zA-Z_\200-\377") >> *qi::char_("a-zA-Z_\200-\3770-9")]]
+			| qi::lexeme['"' >> qi::raw[*(qi::char_ - '"')] >> '"']
+			| qi::raw[qi::lexeme[-qi::char_('-') >>
+				(
+					(qi::char_('.') >> +qi::char_("0-9")) |
+					(+qi::char_("0-9") >> -(qi::char_('.') >> *qi::char_("0-9")))
+				)]]
+			;
+
+		assign = id >> qi::lit('=') >> id;
+	}
+
+	static std::string_view toView(const Range& range)
+	{
+		return std::string_view(range.begin(), range.size());
+	}
+
+	void node_(const Range& name) const { onNode_(toView(name)); }
+
+	void edge_(const Range& source, const Range& target) const
+	{
+		onEdge_(toView(source), toView(target));
+	}
+
+	const Reader::NodeCallback& onNode_;
+	const Reader::EdgeCallback& onEdge_;
+
+	qi::rule<Iterator, bool(), ascii::space_type> directed;
+	qi::rule<Iterator, Range(), ascii::space_type> id, node_id;
+	qi::rule<Iterator, qi::locals<Range>, ascii::space_type> edge_stmt;
+	qi::rule<Iterator, ascii::space_type> graph, stmt_list, stmt, attr_stmt,
+		attr_list, node_stmt, edge_op, compass_pt, assign;
+};
+
+bool Reader::parseStructure(const char* begin, const char* end,
+                            bool& isDirected, const NodeCallback& onNode,
+                            const EdgeCallback& onEdge)
+{
+	const DotStructureGrammar parser(isDirected, onNode, onEdge);
+	isDirected = false;
+	bool result = qi::phrase_parse(begin, end, parser, ascii::space);
+
+	if(!result) {
+		std::string remainder(begin, std::min<size_t>(end - begin, 80) + begin);
+		std::cout << "Parsing failed.\nStopped at: \"" << remainder << "\"\n";
+	}
+
+	return result;
+}
+
 bool Reader::parse(const char* begin, const char* end)
 {
 	using iterator_type = const char*;
@@ -174,7 +285,8 @@ bool Reader::parse(const char* begin, const char* end)
 	bool result = qi::phrase_parse(begin, end, parser, ascii::space, network_);
 
 	if(!result) {
-		std::string remainder(begin, end);
+		// Only show the beginning, the remainder of large graphs may be huge
+		std::string remainder(begin, std::min<size_t>(end - begin, 80) + begin);
 		std::cout << "Parsing failed.\nStopped at: \"" << remainder << "\"\n";
 
 		// Clear everything we parsed
@@ -197,18 +309,22 @@ bool Graph::hasNode(const NodeId& id) const {
 }
 
 bool Reader::postProcess_() {
+	// Names of all known nodes, avoids a linear search per edge
+	std::unordered_set<std::string> known;
+	known.reserve(network_.nodes.size() + network_.edges.size());
 	for(auto& n : network_.nodes) {
 		n.name.normalize();
+		known.insert(n.name.name);
 	}
 
 	for(auto& e : network_.edges) {
 		e.source.normalize();
-		if(!network_.hasNode(e.source)) {
+		if(known.insert(e.source.name).second) {
 			network_.nodes.emplace_back(e.source);
 		}
 
 		e.target.normalize();
-		if(!network_.hasNode(e.target)) {
+		if(known.insert(e.target.name).second) {
 			network_.nodes.emplace_back(e.target);
 		}
 	}
@@ -1,8 +1,10 @@
 #ifndef DOT_READER_H
 #define DOT_READER_H
 
+#include <functional>
 #include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace Dot
@@ -68,6 +70,27 @@ struct Graph {
  */
 class Reader {
 public:
+	using NodeCallback = std::function<void(std::string_view)>;
+	using EdgeCallback = std::function<void(std::string_view, std::string_view)>;
+
+	/**
+	 * Parse a stream of characters without building a Graph, e.g. for large
+	 * graphs. The names of the nodes are passed to the callbacks in the order
+	 * in which they occur, pointing into the parsed characters. Ports and
+	 * attributes are skipped. An edge statement a -> b -> c yields the edges
+	 * (a, b) and (b, c), its nodes are not passed to onNode.
+	 *
+	 * @param isDirected receives whether the graph is a digraph
+	 * @param onNode called for every node statement
+	 * @param onEdge called with the source and the target of every edge
+	 *
+	 * @return true if parsing was successful, false otherwise. The callbacks
+	 * may have been called for the statements before the error.
+	 */
+	static bool parseStructure(const char* begin, const char* end,
+	                           bool& isDirected, const NodeCallback& onNode,
+	                           const EdgeCallback& onEdge);
+
 	/**
 	 * Parse a stream of characters.
 	 *
@@ -1,78 +1,367 @@
 #include "EM.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <thread>
 
 EM::EM(Network& network, Matrix<int>& observations, float difference,
        unsigned int runs)
+    : EM(network, observations, [difference, runs]() {
+	      EMSettings settings;
+	      settings.differenceThreshold = difference;
+	      settings.maxRuns = runs;
+	      return settings;
+      }())
+{
+}
+
+EM::EM(Network& network, Matrix<int>& observations, const EMSettings& settings)
     : network_(network),
+      method_(0),
+      convertedObservations_(observations),
+      observations_(convertedObservations_),
+      probHandler_(network),
+      settings_(settings)
+{
+	performEM();
+}
+
+EM::EM(Network& network, const ObservationCodes& observations,
+       const EMSettings& settings)
+    : network_(network),
+      method_(0),
       observations_(observations),
       probHandler_(network),
-      differenceThreshold_(difference),
-      maxRuns_(runs)
+      settings_(settings)
 {
 	performEM();
 }
 
+namespace
+{
+// Stands in for the samples if EM only gets the observation counts
+const ObservationCodes noObservations;
+}
+
+EM::EM(Network& network, const EMSettings& settings)
+    : EM(network, noObservations, settings)
+{
+}
+
+EM::EM(Network& network, const ObservationCodes& observations,
+       const EMSettings& settings, unsigned int method)
+    : network_(network),
+      method_(method),
+      observations_(observations),
+      probHandler_(network),
+      settings_(settings)
+{
+}
+
 void EM::performEM()
 {
+	CT_TRACE_SCOPE("EM::performEM");
 	start = std::chrono::system_clock::now();
 	// Check completness of the data
-	if(observations_.contains(-1)) {
-		// Determine the best initialization method
-		method_ = getMaxMethod_();
-		// Perform another EM run with the best method.
-		std::tie(finalDifference_, neededRuns_) = runEMIterations_();
+	const auto& nodes = network_.getNodes();
+	if(std::any_of(nodes.begin(), nodes.end(),
+	               [](const Node& n) { return n.hasNA(); })) {
+		runCandidates_();
 	} else {
 		// Calculate parameters directly
+		method_ = 0;
+		resetExpectedCounts_();
+		iterationStats_.clear();
+#ifdef CAUSALTRAIL_PROFILING
+		const auto iterationStart = Profiling::Clock::now();
+#endif
 		finalDifference_ = mPhase();
 		neededRuns_ = 1;
+#ifdef CAUSALTRAIL_PROFILING
+		iterationStats_.push_back(
+		    {Profiling::Clock::now() - iterationStart, finalDifference_});
+#endif
+	}
+	end = std::chrono::system_clock::now();
+}
+
+void EM::performEM(unsigned int initialisation)
+{
+	CT_TRACE_SCOPE("EM::performEM");
+	if(initialisation >= 2 + settings_.randomRestarts) {
+		throw std::invalid_argument("Unknown initialisation " +
+		                            std::to_string(initialisation));
+	}
+	start = std::chrono::system_clock::now();
+	method_ = initialisation;
+	std::tie(finalDifference_, neededRuns_) = runEMIterations_();
+	for(auto& n : network_.getNodes()) {
+		n.clearDynProgMatrix();
 	}
 	end = std::chrono::system_clock::now();
 }
 
-unsigned int EM::getMaxMethod_()
+namespace
+{
+struct Candidate {
+	explicit Candidate(const Network& n) : network(n) {}
+
+	Network network;
+	float difference = 0.0f;
+	unsigned int runs = 0;
+	float likelihood = -std::numeric_limits<float>::infinity();
+	std::vector<EMIterationStats> iterationStats;
+};
+}
+
+void EM::runCandidates_()
 {
-	float maxprob = 0.0f;
-	unsigned int maxmethod = 0;
+	// Every initialisation runs on its own copy of the network, the copies
+	// are made up front as the network must not be read while it is copied
+	const unsigned int candidateCount = 2 + settings_.randomRestarts;
+	std::vector<Candidate> candidates;
+	candidates.reserve(candidateCount);
+	for(unsigned int i = 0; i < candidateCount; i++) {
+		candidates.emplace_back(network_);
+	}
 
-	for(unsigned int method = 0; method < 2; method++) {
-		// Initialize and iterate E/M-Phase
-		method_ = method;
-		runEMIterations_();
-		float prob = calculateLikelihoodOfTheData();
-		if(prob > maxprob) {
-			maxprob = prob;
-			maxmethod = method;
+	std::atomic<unsigned int> nextCandidate(0);
+	const unsigned int threadCount = std::min(
+	    settings_.threads > 0
+	        ? settings_.threads
+	        : std::max(std::thread::hardware_concurrency(), 1u),
+	    candidateCount);
+	std::vector<std::exception_ptr> errors(threadCount);
+	auto worker = [&](unsigned int thread) {
+		try {
+			for(unsigned int i = nextCandidate++; i < candidateCount;
+			    i = nextCandidate++) {
+				CT_TRACE_SCOPE("EM::candidate");
+				Candidate& candidate = candidates[i];
+				EM em(candidate.network, observations_, settings_, i);
+				std::tie(candidate.difference, candidate.runs) =
+				    em.runEMIterations_();
+				candidate.likelihood =
+				    observations_.getColCount() > 0
+				        ? em.calculateLikelihoodOfTheData()
+				        : static_cast<float>(em.calculateObservedLikelihood_());
+				candidate.iterationStats = std::move(em.iterationStats_);
+			}
+		} catch(...) {
+			errors[thread] = std::current_exception();
+			// Let the other threads run out of candidates
+			nextCandidate = candidateCount;
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount);
+	for(unsigned int i = 1; i < threadCount; i++) {
+		threads.emplace_back(worker, i);
+	}
+	worker(0);
+	for(auto& thread : threads) {
+		thread.join();
+	}
+	for(const auto& error : errors) {
+		if(error) {
+			std::rethrow_exception(error);
 		}
 	}
 
-	return maxmethod;
+	// The log-likelihood is negative, on ties the earlier method is kept
+	unsigned int best = 0;
+	for(unsigned int i = 1; i < candidateCount; i++) {
+		if(candidates[i].likelihood > candidates[best].likelihood) {
+			best = i;
+		}
+	}
+
+	Candidate& result = candidates[best];
+	auto& nodes = network_.getNodes();
+	const auto& fitted = result.network.getNodes();
+	for(size_t i = 0; i < nodes.size(); i++) {
+		nodes[i].setProbability(fitted[i].getProbabilityMatrix());
+		nodes[i].clearDynProgMatrix();
+	}
+	method_ = best;
+	finalDifference_ = result.difference;
+	neededRuns_ = result.runs;
+	iterationStats_ = std::move(result.iterationStats);
 }
 
 std::pair<float, unsigned int> EM::runEMIterations_()
 {
 	unsigned int runs = 0;
 	float difference = std::numeric_limits<float>::infinity();
+	const bool monitorLikelihood =
+	    settings_.convergence == EMConvergence::LogLikelihood ||
+	    settings_.acceleration == EMAcceleration::SQUAREM;
 
 	initalise();
-	while(difference > differenceThreshold_ && runs < maxRuns_) {
-		ePhase();
-		difference = mPhase();
-		runs++;
+	resetExpectedCounts_();
+	iterationStats_.clear();
+	double likelihood =
+	    monitorLikelihood ? calculateObservedLikelihood_() : 0.0;
+	bool converged = false;
+	while(!converged && runs < settings_.maxRuns) {
+#ifdef CAUSALTRAIL_PROFILING
+		const auto iterationStart = Profiling::Clock::now();
+#endif
+		const double previousLikelihood = likelihood;
+		// A SQUAREM cycle needs three EM steps, the last iterations are plain
+		if(settings_.acceleration == EMAcceleration::SQUAREM &&
+		   runs + 3 <= settings_.maxRuns) {
+			difference = squaremStep_(runs, likelihood);
+		} else {
+			difference = emStep_();
+			runs++;
+			if(monitorLikelihood) {
+				likelihood = calculateObservedLikelihood_();
+			}
+		}
+		// Written as negations, such that a NaN stops the iterations
+		if(settings_.convergence == EMConvergence::LogLikelihood) {
+			const double change = std::fabs(likelihood - previousLikelihood);
+			converged = !(change > settings_.likelihoodThreshold *
+			                           std::max(1.0, std::fabs(previousLikelihood)));
+		} else {
+			converged = !(difference > settings_.differenceThreshold);
+		}
+#ifdef CAUSALTRAIL_PROFILING
+		iterationStats_.push_back(
+		    {Profiling::Clock::now() - iterationStart, difference});
+#endif
 	}
 
 	return std::make_pair(difference, runs);
 }
 
+float EM::emStep_()
+{
+	ePhase();
+	return mPhase();
+}
+
+float EM::squaremStep_(unsigned int& runs, double& likelihood)
+{
+	const std::vector<float> theta0 = getParameters_();
+	emStep_();
+	const std::vector<float> theta1 = getParameters_();
+	float difference = emStep_();
+	runs += 2;
+	const std::vector<float> theta2 = getParameters_();
+	const double plainLikelihood = calculateObservedLikelihood_();
+
+	// r is the first difference, v the second one
+	double rNorm = 0.0;
+	double vNorm = 0.0;
+	for(size_t i = 0; i < theta0.size(); i++) {
+		const double r = theta1[i] - theta0[i];
+		const double v = theta2[i] - 2.0 * theta1[i] + theta0[i];
+		rNorm += r * r;
+		vNorm += v * v;
+	}
+	if(vNorm == 0.0) {
+		likelihood = plainLikelihood;
+		return difference;
+	}
+	// A step length of -1 yields theta2, hence it is the most careful choice
+	const double alpha = std::min(-1.0, -std::sqrt(rNorm / vNorm));
+	std::vector<float> extrapolated(theta0.size());
+	for(size_t i = 0; i < theta0.size(); i++) {
+		const double r = theta1[i] - theta0[i];
+		const double v = theta2[i] - 2.0 * theta1[i] + theta0[i];
+		extrapolated[i] =
+		    static_cast<float>(theta0[i] - 2.0 * alpha * r + alpha * alpha * v);
+	}
+	setParameters_(extrapolated, true);
+	// Stabilising EM step, which also repairs entries clipped to zero
+	const float stabilisedDifference = emStep_();
+	runs++;
+	const double stabilisedLikelihood = calculateObservedLikelihood_();
+	if(stabilisedLikelihood >= plainLikelihood) {
+		likelihood = stabilisedLikelihood;
+		return stabilisedDifference;
+	}
+	setParameters_(theta2, false);
+	likelihood = plainLikelihood;
+	return difference;
+}
+
+double EM::calculateObservedLikelihood_() const
+{
+	double likelihood = 0.0;
+	for(const auto& n : network_.getNodes()) {
+		const Table<int>& obMatrix = n.getObservationMatrix();
+		const Table<float>& probMatrix = n.getProbabilityMatrix();
+		// Missing values do not contribute, as every CPT row sums to one
+		const unsigned int offset = n.hasNA() ? 1 : 0;
+		for(unsigned int row = 0; row < probMatrix.getRowCount(); row++) {
+			for(unsigned int col = 0; col < probMatrix.getColCount(); col++) {
+				const int count = obMatrix(col + offset, row);
+				if(count > 0) {
+					likelihood += count * std::log(probMatrix(col, row));
+				}
+			}
+		}
+	}
+	return likelihood;
+}
+
+std::vector<float> EM::getParameters_() const
+{
+	std::vector<float> parameters;
+	for(const auto& n : network_.getNodes()) {
+		const Table<float>& probMatrix = n.getProbabilityMatrix();
+		const float* data = probMatrix.getData();
+		parameters.insert(parameters.end(), data,
+		                  data + static_cast<size_t>(probMatrix.getColCount()) *
+		                             probMatrix.getRowCount());
+	}
+	return parameters;
+}
+
+void EM::setParameters_(const std::vector<float>& parameters, bool project)
+{
+	auto value = parameters.begin();
+	for(auto& n : network_.getNodes()) {
+		Table<float>& probMatrix = n.getProbabilityMatrix();
+		for(unsigned int row = 0; row < probMatrix.getRowCount(); row++) {
+			float sum = 0.0f;
+			for(unsigned int col = 0; col < probMatrix.getColCount(); col++) {
+				float p = *value++;
+				if(project && !(p > 0.0f)) {
+					p = 0.0f;
+				}
+				probMatrix(col, row) = p;
+				sum += p;
+			}
+			if(project && sum > 0.0f) {
+				for(unsigned int col = 0; col < probMatrix.getColCount(); col++) {
+					probMatrix(col, row) /= sum;
+				}
+			}
+		}
+	}
+}
+
 float EM::calculateProbabilityEM(Node& n, unsigned int col, unsigned int row)
 {
 	// get Parents
-	auto ParentIDs = n.getParents();
-	const Matrix<float>& probMatrix = n.getProbabilityMatrix();
+	const auto& ParentIDs = n.getParents();
+	const Table<float>& probMatrix = n.getProbabilityMatrix();
 
 	// compute TotProbParentsRec
 	float totProbParents = 1.0f;
 	for(unsigned int key = 0; key < n.getNumberOfParents(); key++) {
 		totProbParents *= probHandler_.computeTotalProbability(
-		    ParentIDs[key], network_.reverseFactor(n, key,row));
+		    ParentIDs[key], n.getParentValue(row, key));
 	}
 
 	// computeNormalizingProb
@@ -86,39 +375,59 @@ float EM::calculateProbabilityEM(Node& n, unsigned int col, unsigned int row)
 	return nominator / denominator;
 }
 
-void EM::calculateExpectedValue(unsigned int row, Node& n)
+void EM::calculateExpectedValue(unsigned int row, Node& n,
+                                Table<float>& expected)
 {
-	Matrix<int>& obMatrix = n.getObservationMatrix();	
-	if(obMatrix.hasNACol()) {
-		for(unsigned int col = 1; col < obMatrix.getColCount(); col++) {
-			float value =
-			    obMatrix(col, row) +
-			    calculateProbabilityEM(n, col, row) * obMatrix(0, row);
-			obMatrix.setData(value, col, row);
-		}
+	const Table<int>& obMatrix = n.getObservationMatrix();
+	for(unsigned int col = 1; col < obMatrix.getColCount(); col++) {
+		expected(col, row) =
+		    obMatrix(col, row) +
+		    calculateProbabilityEM(n, col, row) * obMatrix(0, row);
 	}
 }
 
 void EM::ePhase()
 {
-	for(auto& n : network_.getNodes()) {
+	CT_TRACE_SCOPE("EM::ePhase");
+	auto& nodes = network_.getNodes();
+	for(size_t i = 0; i < nodes.size(); i++) {
+		Node& n = nodes[i];
+		if(!n.hasNA()) {
+			continue;
+		}
 		for(unsigned int row = 0; row < n.getNumberOfParentValues(); row++) {
-			calculateExpectedValue(row, n);
+			calculateExpectedValue(row, n, expectedCounts_[i]);
+		}
+	}
+}
+
+void EM::resetExpectedCounts_()
+{
+	const auto& nodes = network_.getNodes();
+	expectedCounts_.resize(nodes.size());
+	for(size_t i = 0; i < nodes.size(); i++) {
+		const Table<int>& obMatrix = nodes[i].getObservationMatrix();
+		Table<float>& expected = expectedCounts_[i];
+		expected.assign(obMatrix.getColCount(), obMatrix.getRowCount(), 0.0f);
+		for(unsigned int row = 0; row < obMatrix.getRowCount(); row++) {
+			for(unsigned int col = 0; col < obMatrix.getColCount(); col++) {
+				expected(col, row) = obMatrix(col, row);
+			}
 		}
 	}
 }
 
 void EM::calculateMaximumLikelihood(unsigned int row, unsigned int& counter,
                                     float& difference, Node& n,
-                                    const Matrix<int>& obMatrix)
+                                    const Table<float>& counts)
 {
-	float rowsum = obMatrix.calculateRowSum(row);
-	if(obMatrix.hasNACol()){
-			for(unsigned int col = 1; col < obMatrix.getColCount(); col++) {
+	float rowsum = counts.calculateRowSum(row);
+	if(n.hasNA()){
+			for(unsigned int col = 1; col < counts.getColCount(); col++) {
 				float probability = 0.0f;
-				if ((rowsum-obMatrix(0,row)) > 0.0){
-					probability = obMatrix(col, row) /
-			    	                (rowsum - obMatrix(0, row));
+				if ((rowsum-counts(0,row)) > 0.0){
+					probability = counts(col, row) /
+			    	                (rowsum - counts(0, row));
 					difference += fabs(n.getProbability(col - 1, row) - probability);
 				}
 				n.setProbability(probability, col - 1, row);
@@ -126,10 +435,10 @@ void EM::calculateMaximumLikelihood(unsigned int row, unsigned int& counter,
 				}
 			}
 	else {
-			for(unsigned int col = 0; col < obMatrix.getColCount(); col++) {
+			for(unsigned int col = 0; col < counts.getColCount(); col++) {
 				float probability =  0.0f;
 				if (rowsum != 0){
-					probability = obMatrix(col, row) / rowsum;
+					probability = counts(col, row) / rowsum;
 					difference += fabs(n.getProbability(col, row) - probability);
 				}
 				n.setProbability(probability, col, row);
@@ -140,13 +449,14 @@ void EM::calculateMaximumLikelihood(unsigned int row, unsigned int& counter,
 
 float EM::mPhase()
 {
+	CT_TRACE_SCOPE("EM::mPhase");
 	float difference = 0.0f;
 	unsigned int counter = 0;
-	for(auto& n : network_.getNodes()) {
-		const Matrix<int>& obMatrix = n.getObservationMatrix();
-		for(unsigned int row = 0; row < obMatrix.getRowCount(); row++)
-			calculateMaximumLikelihood(row, counter, difference, n, obMatrix);
-		n.loadBackup();
+	auto& nodes = network_.getNodes();
+	for(size_t i = 0; i < nodes.size(); i++) {
+		const Table<float>& counts = expectedCounts_[i];
+		for(unsigned int row = 0; row < counts.getRowCount(); row++)
+			calculateMaximumLikelihood(row, counter, difference, nodes[i], counts);
 	}
 	return difference / counter;
 }
@@ -161,13 +471,16 @@ void EM::initalise()
 		case 1:
 			initaliseAccordingToInitialDistribution();
 			break;
+		default:
+			initaliseRandomly();
+			break;
 	}
 }
 
 void EM::initaliseAssumingUniformDistribution()
 {
 	for(auto& n : network_.getNodes()) {
-		const Matrix<float>& probMatrix = n.getProbabilityMatrix();
+		const Table<float>& probMatrix = n.getProbabilityMatrix();
 		for(unsigned int row = 0; row < probMatrix.getRowCount(); row++) {
 			for(unsigned int col = 0; col < probMatrix.getColCount(); col++) {
 				n.setProbability(1.0f / n.getNumberOfUniqueValuesExcludingNA(),
@@ -180,31 +493,59 @@ void EM::initaliseAssumingUniformDistribution()
 void EM::initaliseAccordingToInitialDistribution()
 {
 	for(auto& n : network_.getNodes()) {
-		const Matrix<int>& obMatrix = n.getObservationMatrix();
-		const Matrix<float>& probMatrix = n.getProbabilityMatrix();
+		const Table<int>& obMatrix = n.getObservationMatrix();
+		const Table<float>& probMatrix = n.getProbabilityMatrix();
+		const unsigned int offset = n.hasNA() ? 1 : 0;
 		for(unsigned int row = 0; row < probMatrix.getRowCount(); row++) {
-			float rowsum = obMatrix.calculateRowSum(row);
+			float observed = obMatrix.calculateRowSum(row);
+			if(n.hasNA()) {
+				observed -= obMatrix(0, row);
+			}
 			for(unsigned int col = 0; col < probMatrix.getColCount(); col++) {
-				if(obMatrix.hasNACol()) {
-					n.setProbability(
-					    n.getObservationMatrix()(col + 1, row) /
-					        (rowsum - n.getObservationMatrix()(0, row)),
-					    col, row);
+				// Rows without observed values start from a uniform distribution
+				if(observed > 0.0f) {
+					n.setProbability(obMatrix(col + offset, row) / observed,
+					                 col, row);
 				} else {
 					n.setProbability(
-					    n.getObservationMatrix()(col, row) / rowsum, col, row);
+					    1.0f / n.getNumberOfUniqueValuesExcludingNA(), col, row);
 				}
 			}
 		}
 	}
 }
 
+void EM::initaliseRandomly()
+{
+	std::mt19937 generator(settings_.seed + method_);
+	std::uniform_real_distribution<float> weight(0.05f, 1.0f);
+	for(auto& n : network_.getNodes()) {
+		const Table<float>& probMatrix = n.getProbabilityMatrix();
+		std::vector<float> weights(probMatrix.getColCount());
+		for(unsigned int row = 0; row < probMatrix.getRowCount(); row++) {
+			float sum = 0.0f;
+			for(auto& w : weights) {
+				w = weight(generator);
+				sum += w;
+			}
+			for(unsigned int col = 0; col < probMatrix.getColCount(); col++) {
+				n.setProbability(weights[col] / sum, col, row);
+			}
+		}
+	}
+}
+
 float EM::calculateLikelihoodOfTheData()
 {
 	return probHandler_.calculateLikelihoodOfTheData(observations_);
 }
 
 
+unsigned int EM::getInitialisation() const
+{
+	return method_;
+}
+
 int EM::getNumberOfRuns(){
 	return neededRuns_;
 }
@@ -217,4 +558,9 @@ float EM::getDifference(){
 int EM::getTimeInMicroSeconds(){
 	return std::chrono::duration_cast<std::chrono::microseconds>
                              (end-start).count();
+}
+
+const std::vector<EMIterationStats>& EM::getIterationStats() const
+{
+	return iterationStats_;
 }	
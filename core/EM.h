@@ -1,7 +1,9 @@
 #ifndef EM_H
 #define EM_H
 
+#include "EMSettings.h"
 #include "ProbabilityHandler.h"
+#include "Profiling.h"
 
 #include <cmath>
 #include <chrono>
@@ -11,7 +13,8 @@ class EM{
 	/**
 	 * This class performs the EM algorithm as described in Probablistic Graphical Models by
 	 * Koller & Friedmann.
-	 * The network is fitted given the data using 2 different initialisation techniques. According to
+	 * The network is fitted given the data using a uniform, a data based and optionally several
+	 * random initialisations, which are run concurrently on copies of the network. According to
 	 * the log-likelihood, the most probable parameters are chosen.
 	 *
 	 * @param network A reference to the network
@@ -19,9 +22,39 @@ class EM{
 	 * @param differenceThreshold_ The threshold for convergence of the EM algorithm (default is 0.0001)
 	 * @param maxRuns_ The allowed number of iterations for the EM algorithm (default is 10000)
 	 *
+	 * Conversion shim for callers holding a matrix: the observations are
+	 * copied into ObservationCodes, hence both are kept in memory while the
+	 * EM runs. New code should pass ObservationCodes.
 	 */
 	EM(Network& network, Matrix<int>& observations_,float differenceThreshold_ = 0.0001f, unsigned int maxRuns_=10000);	
 
+	/**
+	 * @param network A reference to the network
+	 * @param observations_ A matrix of type int containing the discretised sample data
+	 * @param settings Parameters of the EM algorithm
+	 *
+	 * Conversion shim, which copies the observations into ObservationCodes.
+	 */
+	EM(Network& network, Matrix<int>& observations_, const EMSettings& settings);
+
+	/**
+	 * @param network A reference to the network
+	 * @param observations The discretised sample data
+	 * @param settings Parameters of the EM algorithm
+	 */
+	EM(Network& network, const ObservationCodes& observations, const EMSettings& settings);
+
+	/**
+	 * Fits the network given the observation counts of its nodes only, e.g.
+	 * if the samples do not fit into memory. The initialisations are compared
+	 * by the log-likelihood of the counts and calculateLikelihoodOfTheData
+	 * throws, as no samples are available.
+	 *
+	 * @param network A reference to the network with distributed observations
+	 * @param settings Parameters of the EM algorithm
+	 */
+	EM(Network& network, const EMSettings& settings);
+
 	EM& operator=(const EM&) = delete;
 	EM& operator=(EM&&) = delete;
 
@@ -30,6 +63,17 @@ class EM{
 	 */
 	void performEM();
 
+	/**
+	 * Fits the network again using only the given initialisation instead of
+	 * comparing all of them, e.g. to inspect the convergence of a single run.
+	 *
+	 * @param initialisation 0 for the uniform, 1 for the data based and 2 + i
+	 *                       for the i-th random initialisation
+	 *
+	 * @throw invalid_argument if the initialisation is not configured
+	 */
+	void performEM(unsigned int initialisation);
+
 	/**
 	 * @return The Log-Likelihood of the data given the current network parameters
 	 */
@@ -50,7 +94,29 @@ class EM{
 	 */
 	int getTimeInMicroSeconds();
 
+	/**
+	 * @return Duration and parameter difference of each iteration of the final
+	 * EM run. Only recorded if built with CAUSALTRAIL_PROFILING.
+	 */
+	const std::vector<EMIterationStats>& getIterationStats() const;
+
+	/**
+	 * @return The initialisation that led to the chosen parameters: 0 for the
+	 * uniform, 1 for the data based and 2 + i for the i-th random initialisation
+	 */
+	unsigned int getInitialisation() const;
+
 	private:
+	/**
+	 * Creates an EM run on a copy of the network without executing it.
+	 *
+	 * @param network A reference to the copy of the network
+	 * @param observations The discretised sample data
+	 * @param settings Parameters of the EM algorithm
+	 * @param method The initialisation method
+	 */
+	EM(Network& network, const ObservationCodes& observations, const EMSettings& settings, unsigned int method);
+
 	/**
 	 * @param n A cost reference to the Node in question
 	 * @param col column of the CPT
@@ -68,8 +134,9 @@ class EM{
 	 *
 	 * @param row row of the CPT
 	 * @param n A reference to a node
+	 * @param expected The expected counts of the node, laid out like its observation matrix
 	 */
-	void calculateExpectedValue(unsigned int row, Node& n);
+	void calculateExpectedValue(unsigned int row, Node& n, Table<float>& expected);
 
 	/**
 	 * Executes the ePhase of the EM algorithm
@@ -83,9 +150,16 @@ class EM{
 	 * @param counter a counter for the calculated parameters
 	 * @param difference a reference to the parameter difference
 	 * @param n a reference to the node of interest
-	 * @param obMatrix a const reference to the observation matrix
+	 * @param counts a const reference to the expected counts of the node
 	 */
-	void calculateMaximumLikelihood(unsigned int row, unsigned int& counter, float& difference, Node& n, const Matrix<int> & obMatrix);
+	void calculateMaximumLikelihood(unsigned int row, unsigned int& counter, float& difference, Node& n, const Table<float>& counts);
+
+	/**
+	 * Allocates the expected counts of all nodes and initialises them with the
+	 * observed counts. The E phase overwrites the entries of the observed values
+	 * of nodes with missing values only, hence this is needed once per EM run.
+	 */
+	void resetExpectedCounts_();
 
 	/**
 	 * Executes the mPhase of the EM algorithm.
@@ -109,27 +183,86 @@ class EM{
 	 */
 	void initaliseAccordingToInitialDistribution();
 
+	/**
+	 * Initialises all parameters randomly, seeded by the settings and the method.
+	 */
+	void initaliseRandomly();
+
+	/**
+	 * Runs EM iterations from the initial parameters until convergence.
+	 *
+	 * @return The final parameter difference and the number of EM steps
+	 */
 	std::pair<float, unsigned int> runEMIterations_();
-	unsigned int getMaxMethod_();
+
+	/**
+	 * Performs a single E and M phase.
+	 *
+	 * @return Difference of the parameters between the current and the previous state
+	 */
+	float emStep_();
+
+	/**
+	 * Performs an extrapolated SQUAREM cycle of three EM steps. If the
+	 * extrapolation does not increase the log-likelihood, the result of two
+	 * plain EM steps is kept.
+	 *
+	 * @param runs The number of EM steps, incremented by this method
+	 * @param likelihood The log-likelihood of the result
+	 *
+	 * @return Difference of the parameters of the last EM step
+	 */
+	float squaremStep_(unsigned int& runs, double& likelihood);
+
+	/**
+	 * @return The log-likelihood of the observed values given the current
+	 * parameters, i.e. the objective maximised by EM
+	 */
+	double calculateObservedLikelihood_() const;
+
+	/**
+	 * @return All CPT entries of the network in node order
+	 */
+	std::vector<float> getParameters_() const;
+
+	/**
+	 * Sets all CPT entries of the network.
+	 *
+	 * @param parameters The entries in the order of getParameters_
+	 * @param project If true, the entries are clipped to be non-negative
+	 *                and every CPT row is renormalised
+	 */
+	void setParameters_(const std::vector<float>& parameters, bool project);
+
+	/**
+	 * Runs all initialisations concurrently on copies of the network and
+	 * stores the parameters of the most likely run in the network.
+	 */
+	void runCandidates_();
 
 	//A reference to the network
 	Network& network_;
 	//The initialisation method
 	unsigned int method_;
+	//Observations converted from a matrix of values
+	ObservationCodes convertedObservations_;
 	//The discretised observations
-	Matrix<int>& observations_;
+	const ObservationCodes& observations_;
 	//An instance of the probabilityHandler
 	ProbabilityHandler probHandler_;
-	//The parameter difference
-	float differenceThreshold_;
+	//Parameters of the algorithm
+	EMSettings settings_;
 	//Fields dealing with run information
-	unsigned int maxRuns_;
 	int neededRuns_;	
 	//The resulting parameter difference
 	float finalDifference_;
 	//c++11 time measuring
 	std::chrono::time_point<std::chrono::system_clock> start;
 	std::chrono::time_point<std::chrono::system_clock> end;
+	//Expected counts of every node, laid out like its observation matrix
+	std::vector<Table<float>> expectedCounts_;
+	//Per iteration statistics of the last EM run
+	std::vector<EMIterationStats> iterationStats_;
 };
 
 #endif
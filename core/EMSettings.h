@@ -0,0 +1,51 @@
+#ifndef EMSETTINGS_H
+#define EMSETTINGS_H
+
+/**
+ * Extrapolation applied to the EM iterations
+ */
+enum class EMAcceleration
+{
+	// Plain EM iterations
+	None,
+	// Squared iterative method (SqS3) of Varadhan and Roland, safeguarded
+	// by a stabilising EM step and a monotonicity check
+	SQUAREM
+};
+
+/**
+ * Quantity monitored to decide about the convergence of EM
+ */
+enum class EMConvergence
+{
+	// Mean absolute difference of the CPT entries between two iterations
+	ParameterDifference,
+	// Relative change of the log-likelihood of the observed values
+	LogLikelihood
+};
+
+/**
+ * Parameters of the EM algorithm
+ */
+struct EMSettings
+{
+	// Extrapolation of the iterations
+	EMAcceleration acceleration = EMAcceleration::None;
+	// Criterion used to detect convergence
+	EMConvergence convergence = EMConvergence::ParameterDifference;
+	// The threshold for convergence of the mean parameter difference
+	float differenceThreshold = 0.0001f;
+	// The threshold for convergence of the relative log-likelihood change
+	double likelihoodThreshold = 1e-8;
+	// The allowed number of iterations of a single EM run
+	unsigned int maxRuns = 10000;
+	// Number of runs started from random parameters, in addition to the
+	// uniform and the data based initialisation
+	unsigned int randomRestarts = 0;
+	// Number of threads running the initialisations, 0 uses all cores
+	unsigned int threads = 0;
+	// Seed of the random initialisations
+	unsigned int seed = 42;
+};
+
+#endif
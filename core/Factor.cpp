@@ -1,99 +1,123 @@
 #include "Factor.h"
+#include "Profiling.h"
 #include "cmath"
 #include "algorithm"
 #include <cstdlib>
 
-Factor::Factor(const Node& n, const std::vector<int>& values)
+Factor::Factor(const Node& n, const std::vector<int>& values,
+               std::pmr::memory_resource* resource)
+    : nodeIDs_(resource), val_(resource), probabilities_(resource), length_(0)
 {
-	std::vector<unsigned int> nodeIDs = {n.getID()};
-	nodeIDs.insert(nodeIDs.end(), n.getParents().begin(), n.getParents().end());
-	nodeIDs_ = nodeIDs;
-	length_ = 0;
-	Matrix<float> p = n.getProbabilityMatrix();
-	bool parentsKnown = false;
-	std::vector<unsigned int> knownParents;
-	std::set<std::vector<int>> usedValues;
-	for(auto& id : n.getParents()) {
-		if(values[id] != -1) {
-			parentsKnown = true;
-			knownParents.push_back(id);
+	const auto& parents = n.getParents();
+	const unsigned int width = parents.size() + 1;
+	nodeIDs_.reserve(width);
+	nodeIDs_.push_back(n.getID());
+	nodeIDs_.insert(nodeIDs_.end(), parents.begin(), parents.end());
+	const Table<float>& p = n.getProbabilityMatrix();
+	CT_PROFILE_COUNT(factorsCreated, 1);
+	if(p.getRowCount() == 0) {
+		return;
+	}
+
+	// The CPT is sliced by the evidence: known parents contribute a fixed
+	// offset to the row, the remaining parents are enumerated with their
+	// strides, the last parent changing fastest. Without parents, e.g. if
+	// they have been cut by a do intervention, only the first row is used.
+	const auto& radices = n.getParentValueNameLists();
+	unsigned int baseRow = 0;
+	std::pmr::vector<unsigned int> freeParents(resource);
+	std::pmr::vector<unsigned int> strides(parents.size(), resource);
+	unsigned int stride = 1;
+	size_t rowCount = 1;
+	for(size_t i = parents.size(); i-- > 0;) {
+		const unsigned int radix = radices[i].size();
+		strides[i] = stride;
+		stride *= radix;
+		const int value = values[parents[i]];
+		if(value == -1) {
+			freeParents.push_back(i);
+			rowCount *= radix;
+		} else if(static_cast<unsigned int>(value) < radix) {
+			baseRow += value * strides[i];
+		} else {
+			return;
 		}
 	}
-	if(values[n.getID()] == -1) {
-		for(unsigned int col = 0; col < p.getColCount(); col++) {
-			for(unsigned int row = 0; row < p.getRowCount(); row++) {
-				std::vector<int> v{n.getUniqueValuesExcludingNA()[col]};
-				if(n.getNumberOfParents() != 0) {
-					v.insert(v.end(), n.getParentValues()[row].begin(),
-					         n.getParentValues()[row].end());
-				}
-				if(!parentsKnown && (usedValues.find(v) ==
-				                         usedValues.end())) {
-					val_.insert(val_.end(), v.begin(), v.end());
-					addProbability(p(col, row));
-					length_++;
-					usedValues.insert(v);
-				} else {
-					bool useRow = true;
-					for(auto& id : knownParents) {
-						if(v[getIndex(id)] != values[id]) {
-							useRow = false;
-						}
-					}
-					if(useRow && (usedValues.find(v) == usedValues.end())) {
-						val_.insert(val_.end(), v.begin(), v.end());
-						addProbability(p(col, row));
-						length_++;
-						usedValues.insert(v);
-					}
-				}
-			}
+	std::reverse(freeParents.begin(), freeParents.end());
+
+	const int value = values[n.getID()];
+	unsigned int firstCol = 0;
+	unsigned int lastCol = p.getColCount();
+	if(value != -1) {
+		firstCol = value;
+		lastCol = value + 1;
+	}
+	length_ = (lastCol - firstCol) * rowCount;
+	CT_PROFILE_MAX(maxFactorSize, length_);
+	val_.resize(static_cast<size_t>(length_) * width);
+	probabilities_.resize(length_);
+
+	// Values of the parents for the current row, the values of the free
+	// parents are their digits in the enumeration
+	std::pmr::vector<int> parentValues(resource);
+	for(auto id : parents) {
+		parentValues.push_back(values[id]);
+	}
+	size_t index = 0;
+	for(unsigned int col = firstCol; col < lastCol; col++) {
+		const int nodeValue =
+		    value == -1 ? n.getUniqueValuesExcludingNA()[col] : value;
+		unsigned int row = baseRow;
+		for(auto i : freeParents) {
+			parentValues[i] = 0;
 		}
-	} else {
-		for(unsigned int row = 0; row < p.getRowCount(); row++) {
-			std::vector<int> v{values[n.getID()]};
-			if(n.getNumberOfParents() != 0) {
-				v.insert(v.end(), n.getParentValues()[row].begin(),
-				         n.getParentValues()[row].end());
-			}
-			if(!parentsKnown && (usedValues.find(v) == usedValues.end())) {
-				val_.insert(val_.end(), v.begin(), v.end());
-				addProbability(p(values[n.getID()], row));
-				length_++;
-				usedValues.insert(v);
-			} else {
-				bool useRow = true;
-				for(auto& id : knownParents) {
-					if(v[getIndex(id)] != values[id]) {
-						useRow = false;
-					}
-				}
-				if(useRow && (usedValues.find(v) == usedValues.end())) {
-					val_.insert(val_.end(), v.begin(), v.end());
-					addProbability(p(values[n.getID()], row));
-					length_++;
-					usedValues.insert(v);
+		for(size_t r = 0; r < rowCount; r++) {
+			int* v = &val_[index * width];
+			v[0] = nodeValue;
+			std::copy(parentValues.begin(), parentValues.end(), v + 1);
+			probabilities_[index] = p(col, row);
+			index++;
+			// Advance the free parents like a mixed radix counter
+			for(size_t d = freeParents.size(); d-- > 0;) {
+				const unsigned int i = freeParents[d];
+				row += strides[i];
+				if(++parentValues[i] < static_cast<int>(radices[i].size())) {
+					break;
 				}
+				row -= strides[i] * parentValues[i];
+				parentValues[i] = 0;
 			}
 		}
 	}
 }
 
-Factor::Factor(unsigned int length, std::vector<unsigned int> ids)
-    : nodeIDs_(ids),
-      val_(length * ids.size()),
-      probabilities_(length),
+Factor::Factor(unsigned int length, const std::vector<unsigned int>& ids,
+               std::pmr::memory_resource* resource)
+    : Factor(length,
+             std::pmr::vector<unsigned int>(ids.begin(), ids.end(), resource))
+{
+}
+
+Factor::Factor(unsigned int length, std::pmr::vector<unsigned int> ids)
+    : nodeIDs_(std::move(ids)),
+      val_(length * nodeIDs_.size(), nodeIDs_.get_allocator()),
+      probabilities_(length, nodeIDs_.get_allocator()),
       length_(length)
 {
 }
 
-std::vector<unsigned int> Factor::getCommonIDs(const Factor& factor) const
+std::pmr::memory_resource* Factor::resource() const
+{
+	return nodeIDs_.get_allocator().resource();
+}
+
+std::pmr::vector<unsigned int> Factor::getCommonIDs(const Factor& factor) const
 {
-	std::vector<unsigned int> intersection;
+	std::pmr::vector<unsigned int> intersection(resource());
 	intersection.reserve(std::min(nodeIDs_.size(), factor.getIDs().size()));
 
-	std::vector<unsigned int> thisIDs = nodeIDs_;
-	std::vector<unsigned int> otherIDs = factor.getIDs();
+	std::pmr::vector<unsigned int> thisIDs(nodeIDs_, resource());
+	std::pmr::vector<unsigned int> otherIDs(factor.getIDs(), resource());
 	std::sort(thisIDs.begin(), thisIDs.end());
 	std::sort(otherIDs.begin(), otherIDs.end());
 
@@ -102,11 +126,11 @@ std::vector<unsigned int> Factor::getCommonIDs(const Factor& factor) const
 	return intersection;
 }
 
-std::vector<unsigned int>
-Factor::getUnionOfIDs(const std::vector<unsigned int>& commonIDs,
+std::pmr::vector<unsigned int>
+Factor::getUnionOfIDs(const std::pmr::vector<unsigned int>& commonIDs,
                       const Factor& factor) const
 {
-	std::vector<unsigned int> uni = nodeIDs_;
+	std::pmr::vector<unsigned int> uni(nodeIDs_, resource());
 	for(auto& id : factor.getIDs()) {
 		if(std::find(commonIDs.begin(), commonIDs.end(), id) ==
 		   commonIDs.end()) {
@@ -134,17 +158,21 @@ void Factor::normalize(){
 
 Factor Factor::product(Factor& factor, const Network& network_, const std::vector<int>& values)
 {
-	std::vector<unsigned int> commonIDs = getCommonIDs(factor);
-	std::vector<unsigned int> unionIDs = getUnionOfIDs(commonIDs, factor);
-	std::vector<unsigned int> uniqueIDs(unionIDs.begin() + nodeIDs_.size(),
-	                                    unionIDs.end());
+	std::pmr::vector<unsigned int> commonIDs = getCommonIDs(factor);
+	std::pmr::vector<unsigned int> unionIDs = getUnionOfIDs(commonIDs, factor);
+	std::pmr::vector<unsigned int> uniqueIDs(unionIDs.begin() + nodeIDs_.size(),
+	                                         unionIDs.end(), resource());
 	int newFactorLength = 1;
 	for (auto& id : unionIDs){
 		if (values[id] == -1){
 			newFactorLength*=network_.getNode(id).getNumberOfUniqueValuesExcludingNA();
 		}
 	}
-	Factor newFactor(newFactorLength, unionIDs);
+	const size_t unionSize = unionIDs.size();
+	Factor newFactor(newFactorLength, std::move(unionIDs));
+	CT_PROFILE_COUNT(products, 1);
+	CT_PROFILE_COUNT(productEntries, newFactorLength);
+	CT_PROFILE_MAX(maxFactorSize, newFactorLength);
 	int counter = 0;
 	for (int i = 0; i< length_; i++){
 		for (int j = 0; j < factor.length_; j++){
@@ -157,11 +185,11 @@ Factor Factor::product(Factor& factor, const Network& network_, const std::vecto
 			}
 			if(valid) {
 				for (unsigned int h = 0; h < nodeIDs_.size(); h++){
-					newFactor.val_[h+counter*unionIDs.size()]=val_[h+i*nodeIDs_.size()];
+					newFactor.val_[h+counter*unionSize]=val_[h+i*nodeIDs_.size()];
 				}
 				int h=nodeIDs_.size();
 				for (auto id : uniqueIDs){
-					newFactor.val_[h+counter*unionIDs.size()]=factor.val_[factor.getIndex(id)+j*factor.nodeIDs_.size()];
+					newFactor.val_[h+counter*unionSize]=factor.val_[factor.getIndex(id)+j*factor.nodeIDs_.size()];
 					h++;
 				}	
 				newFactor.setProbability(getProbability(i) *
@@ -194,9 +222,10 @@ Factor Factor::sumOut(unsigned int id, Network& network_,
 		newFactorLength = length_/(jumptimes+1);
 	}
 	
-	std::vector<unsigned int> newIDs = nodeIDs_;
+	std::pmr::vector<unsigned int> newIDs(nodeIDs_, resource());
 	newIDs.erase(newIDs.begin() + index);
-	Factor newFactor(newFactorLength, newIDs);
+	const size_t newSize = newIDs.size();
+	Factor newFactor(newFactorLength, std::move(newIDs));
 	// std::div only works for _signed_ integers, hence i is of type int
 	for (int i = 0; i < newFactorLength; i++) {
 		float prob = 0.0;
@@ -211,7 +240,7 @@ Factor Factor::sumOut(unsigned int id, Network& network_,
 					if (c > index){
 						d = c - 1;
 					}
-					newFactor.val_[d+i*newIDs.size()]=val_[c+old*nodeIDs_.size()];
+					newFactor.val_[d+i*newSize]=val_[c+old*nodeIDs_.size()];
 				}
 			}
 			newFactor.setProbability(prob,i);	
@@ -231,7 +260,7 @@ unsigned int Factor::getIndex(unsigned int id) const
 	                            "represented by this factor");
 }
 
-const std::vector<unsigned int>& Factor::getIDs() const { return nodeIDs_; }
+const std::pmr::vector<unsigned int>& Factor::getIDs() const { return nodeIDs_; }
 
 void Factor::addProbability(float prob) { probabilities_.push_back(prob); }
 
@@ -3,34 +3,40 @@
 
 #include "Network.h"
 
+#include <memory_resource>
+
 class Factor{
 	public:
 	/**Factor
 	 *
 	 * @param n, a const reference to a node
 	 * @param values, a const reference to known values of the nodes
+	 * @param resource, memory resource used for all tables of the factor
 	 * 
 	 * @return a Factor object
 	 *
 	 */
-	Factor(const Node& n, const std::vector<int>& values);
+	Factor(const Node& n, const std::vector<int>& values,
+	       std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
 	/**Factor
 	 *
 	 * @param length, number of different value combinations represented by the factor
 	 * @param ids, vector of node identifiers represented by the factor
+	 * @param resource, memory resource used for all tables of the factor
 	 * 
 	 * @return a Factor object
 	 *
 	 */
-	Factor(unsigned int length, std::vector<unsigned int> ids);
+	Factor(unsigned int length, const std::vector<unsigned int>& ids,
+	       std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
 	/**getIDs
 	 *
 	 * @return vector of node identifiers represented by the factor
 	 *
 	 */
-	const std::vector<unsigned int>& getIDs() const ;
+	const std::pmr::vector<unsigned int>& getIDs() const ;
 
 	/**addProbability
 	 *
@@ -89,7 +95,8 @@ class Factor{
 	 * 
 	 * @return a new Factor representing the product of the former two
 	 *
-	 * Performs a product operation on two factors
+	 * Performs a product operation on two factors. The result uses the
+	 * memory resource of this factor.
 	 */
 	Factor product(Factor& factor,const Network& network_, const std::vector<int>& values);
 
@@ -123,6 +130,14 @@ class Factor{
 	
 	private:
 
+	/**Factor
+	 *
+	 * @param length, number of different value combinations represented by the factor
+	 * @param ids, vector of node identifiers represented by the factor, its
+	 * memory resource is used for all tables of the factor
+	 */
+	Factor(unsigned int length, std::pmr::vector<unsigned int> ids);
+
 	/**getUnionOfIDs
 	 *
 	 * @param commonIDs, common ids between this factor and the factor to form the union with
@@ -131,7 +146,7 @@ class Factor{
 	 * @return vector containing the union of IDs
 	 *
 	 */
-	std::vector<unsigned int> getUnionOfIDs(const std::vector<unsigned int>& commonIDs, const Factor& factor) const;
+	std::pmr::vector<unsigned int> getUnionOfIDs(const std::pmr::vector<unsigned int>& commonIDs, const Factor& factor) const;
 
 	/**getCommonIDs
 	 *
@@ -140,16 +155,22 @@ class Factor{
 	 * @return vector containing common ids between this and the given factor
 	 *
 	 */
-	std::vector<unsigned int> getCommonIDs(const Factor& factor) const;
+	std::pmr::vector<unsigned int> getCommonIDs(const Factor& factor) const;
+
+	/**resource
+	 *
+	 * @return the memory resource used by this factor
+	 */
+	std::pmr::memory_resource* resource() const;
 
 	//Vector of node identifieres contained in this node
-	std::vector<unsigned int> nodeIDs_;
+	std::pmr::vector<unsigned int> nodeIDs_;
 
 	//Vector representing the values of the represented nodes
-	std::vector<int> val_;
+	std::pmr::vector<int> val_;
 
 	//vector containing the probabilities of the factor
-	std::vector<float> probabilities_;
+	std::pmr::vector<float> probabilities_;
 
 	//Number of different value combinations contained in the factor
 	int length_;
@@ -0,0 +1,73 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CAUSALTRAIL_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+#ifdef CAUSALTRAIL_USE_MMAP
+MappedFile::MappedFile(const std::string& filename)
+    : mapping_(nullptr), size_(0)
+{
+	int fd = open(filename.c_str(), O_RDONLY);
+	if(fd < 0) {
+		throw std::invalid_argument("File not found");
+	}
+	struct stat status;
+	if(fstat(fd, &status) != 0 || !S_ISREG(status.st_mode)) {
+		close(fd);
+		throw std::invalid_argument("File not found");
+	}
+	size_ = static_cast<size_t>(status.st_size);
+	if(size_ > 0) {
+		mapping_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(mapping_ == MAP_FAILED) {
+			mapping_ = nullptr;
+			close(fd);
+			throw std::invalid_argument("Cannot map file '" + filename + "'");
+		}
+		madvise(mapping_, size_, MADV_SEQUENTIAL);
+	}
+	// The mapping stays valid after closing the descriptor
+	close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+	if(mapping_ != nullptr) {
+		munmap(mapping_, size_);
+	}
+}
+
+std::string_view MappedFile::getContent() const
+{
+	if(mapping_ == nullptr) {
+		return std::string_view();
+	}
+	return std::string_view(static_cast<const char*>(mapping_), size_);
+}
+#else
+MappedFile::MappedFile(const std::string& filename)
+    : mapping_(nullptr), size_(0)
+{
+	std::ifstream input(filename, std::ifstream::in | std::ifstream::binary);
+	if(!input.good()) {
+		throw std::invalid_argument("File not found");
+	}
+	buffer_.assign(std::istreambuf_iterator<char>(input),
+	               std::istreambuf_iterator<char>());
+	size_ = buffer_.size();
+}
+
+MappedFile::~MappedFile() {}
+
+std::string_view MappedFile::getContent() const { return buffer_; }
+#endif
@@ -0,0 +1,46 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * Read-only view of the content of a file. On POSIX systems the file is
+ * mapped into memory, such that it can be parsed without copying it into
+ * stream buffers. On other systems the content is read into a string.
+ */
+class MappedFile
+{
+	public:
+	/**MappedFile
+	 *
+	 * @param filename, path of the file to be opened
+	 *
+	 * @return a MappedFile object
+	 *
+	 * @throw invalid_argument if the file can not be opened
+	 */
+	explicit MappedFile(const std::string& filename);
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	~MappedFile();
+
+	/**getContent
+	 *
+	 * @return the content of the file, valid as long as this object exists
+	 */
+	std::string_view getContent() const;
+
+	private:
+	//Start of the mapped memory, nullptr if the file is empty or not mapped
+	void* mapping_;
+	//Size of the file in bytes
+	size_t size_;
+	//Content of the file if memory mapping is not available
+	std::string buffer_;
+};
+
+#endif
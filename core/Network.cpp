@@ -1,5 +1,9 @@
 #include "Network.h"
+#include "DotReader.h"
+#include "MappedFile.h"
 
+#include <algorithm>
+#include <charconv>
 #include <ctime>
 #include <chrono>
 #include <fstream>
@@ -11,17 +15,58 @@ Network::Network()
 	ExtensionToIndex_[".tgf"] = 1;
 	ExtensionToIndex_[".na"] = 2;
 	ExtensionToIndex_[".sif"] = 3;
+	ExtensionToIndex_[".dot"] = 4;
+	ExtensionToIndex_[".gv"] = 4;
 }
 
-struct Comp {
-    bool operator()(std::pair<unsigned int, unsigned int> p, unsigned int s) const
-    { return p.first < s; }
-    bool operator()(unsigned int s, std::pair<unsigned int, unsigned int> p) const
-    { return s < p.first; }
-    bool operator()(std::pair<unsigned int, unsigned int> p1,std::pair<unsigned int,unsigned int> p2) const
-    { return p1.first < p2.first; }
-  
-};
+namespace {
+// Separators of the fields in the network files
+bool isSeparator(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+// Removes the first line from content and returns it
+std::string_view nextLine(std::string_view& content)
+{
+	const size_t end = content.find('\n');
+	std::string_view line = content.substr(0, end);
+	content.remove_prefix(end == std::string_view::npos ? content.size()
+	                                                    : end + 1);
+	return line;
+}
+
+// Removes the first field from line and returns it, empty if there is none
+std::string_view nextToken(std::string_view& line)
+{
+	size_t begin = 0;
+	while(begin < line.size() && isSeparator(line[begin])) {
+		begin++;
+	}
+	size_t end = begin;
+	while(end < line.size() && !isSeparator(line[end])) {
+		end++;
+	}
+	std::string_view token = line.substr(begin, end - begin);
+	line.remove_prefix(end);
+	return token;
+}
+
+unsigned int parseIdentifier(std::string_view token)
+{
+	unsigned int id = 0;
+	const char* last = token.data() + token.size();
+	auto res = std::from_chars(token.data(), last, id);
+	if(token.empty() || res.ec != std::errc() || res.ptr != last) {
+		throw std::invalid_argument("Invalid node identifier '" +
+		                            std::string(token) + "'");
+	}
+	return id;
+}
+
+// Upper bound for the number of lines, used to reserve memory
+size_t countLines(std::string_view content)
+{
+	return std::count(content.begin(), content.end(), '\n') + 1;
+}
+}
 
 unsigned int Network::getIndex(const std::string& name) const
 {
@@ -34,14 +79,8 @@ unsigned int Network::getIndex(const std::string& name) const
 
 const std::vector<unsigned int> Network::getParents(unsigned int id) const
 {
-	std::vector<unsigned int> parentIDs;
-	unsigned int index = id;
-	for(unsigned int row = 0; row < AdjacencyMatrix_.getRowCount(); row++) {
-		if(AdjacencyMatrix_(index, row) == 1) {
-			parentIDs.push_back(row);
-		}
-	}
-	return parentIDs;
+	auto parents = Adjacency_.getParents(id);
+	return std::vector<unsigned int>(parents.begin(), parents.end());
 }
 
 const std::vector<unsigned int> Network::getParents(const Node& n) const
@@ -62,6 +101,7 @@ const std::vector<Node>& Network::getNodes() const { return NodeList_; }
 void Network::cutParents(unsigned int id)
 {
 	getNode(id).cutParents();
+	invalidateStructureCache();
 }
 
 void Network::cutParents(const std::string& name)
@@ -71,8 +111,9 @@ void Network::cutParents(const std::string& name)
 
 void Network::addEdge(unsigned int id1, unsigned int id2)
 {
-	AdjacencyMatrix_.setData(1, id1, id2);
+	Adjacency_.addEdge(id1, id2);
 	getNode(id1).setParents(getParents(id1));
+	invalidateStructureCache();
 }
 
 void Network::addEdge(const std::string& name1, const std::string& name2)
@@ -83,8 +124,9 @@ void Network::addEdge(const std::string& name1, const std::string& name2)
 
 void Network::removeEdge(unsigned int id1, unsigned int id2)
 {
-	AdjacencyMatrix_.setData(0, id1, id2);
+	Adjacency_.removeEdge(id1, id2);
 	getNode(id1).setParents(getParents(id1));
+	invalidateStructureCache();
 }
 
 void Network::removeEdge(const std::string& name1, const std::string& name2)
@@ -111,7 +153,7 @@ const Node& Network::getNode(const std::string& name) const
 
 std::ostream& operator<<(std::ostream& os, const Network& n)
 {
-	os << "Adjacency matrix:\n" << n.AdjacencyMatrix_ << "\n\n";
+	os << "Parents:\n" << n.Adjacency_ << "\n";
 	for(const Node& node : n.NodeList_) {
 		os << node << "\n";
 	}
@@ -136,132 +178,185 @@ void Network::readNetwork(const std::string& filename)
 		case 3:
 			readSIF(filename);
 			break;
+		case 4:
+			readDot(filename);
+			break;
 		default:
 			throw std::invalid_argument("Unsupported file type");
 	}
 	assignParents();
+	invalidateStructureCache();
 	if (checkCycleExistence()){
 		throw std::invalid_argument("The specified network contains a cycle. Thus, it can not be used.");
 	}
 }
 
+void Network::createNetwork(const std::vector<std::string>& names,
+                            const std::vector<AdjacencyList::Edge>& edges)
+{
+	resetNodes(names.size());
+	for(unsigned int id = 0; id < names.size(); id++) {
+		addNodeFromFile(id, names[id]);
+	}
+	Adjacency_.reset(NodeList_.size());
+	Adjacency_.addEdges(edges);
+	assignParents();
+	invalidateStructureCache();
+	if(checkCycleExistence()) {
+		throw std::invalid_argument("The specified network contains a cycle. Thus, it can not be used.");
+	}
+}
+
 void Network::readTGF(const std::string& filename)
 {
-	NodeList_.clear();
-	AdjacencyMatrix_.clear();
-	std::string line;
-	std::ifstream input(filename, std::ifstream::in);
-	if (! input.good()){
-		throw std::invalid_argument("File not found");
-		}
+	MappedFile file(filename);
+	std::string_view content = file.getContent();
+	resetNodes(countLines(content));
 
-	std::string name;
-	unsigned int index = 0;
-	std::vector<std::string> names;
-	while(std::getline(input, line)) {
-		if(line == "#")
+	while(!content.empty()) {
+		std::string_view line = nextLine(content);
+		std::string_view idToken = nextToken(line);
+		if(idToken == "#") {
 			break;
-		std::stringstream buffer;
-		buffer << line;
-
-		size_t id1;
-		buffer >> id1 >> name;
-		id1=getDenseNodeIdentifier(id1);
-		NodeList_.push_back(Node(0, id1, name));
-		IDToIndex_[id1] = index;
-		NameToIndex_[name] = index;
-		std::stringstream nbuffer;
-		nbuffer << id1;
-		std::string ids;
-		nbuffer >> ids;
-		names.push_back(ids);
-		index++;
-	}
-	AdjacencyMatrix_.resize(NodeList_.size(), NodeList_.size(), 0);
-	AdjacencyMatrix_.setRowNames(names);
-	AdjacencyMatrix_.setColNames(names);
-	std::sort(originalIDToDense_.begin(), originalIDToDense_.end(),Comp());
-	bool edges = false;
-	while(std::getline(input, line)) {
-		edges=true;
-		std::stringstream buffer;
-		buffer << line;
-		size_t id1, id2;
-		buffer >> id1 >> id2;
-		addEdge(getNewID(id2),getNewID(id1));
-	}
-	if (!edges){
+		}
+		if(idToken.empty()) {
+			continue;
+		}
+		std::string_view name = nextToken(line);
+		addNodeFromFile(parseIdentifier(idToken), name.empty() ? idToken : name);
+	}
+
+	std::vector<AdjacencyList::Edge> edges;
+	edges.reserve(countLines(content));
+	while(!content.empty()) {
+		std::string_view line = nextLine(content);
+		std::string_view source = nextToken(line);
+		if(source.empty()) {
+			continue;
+		}
+		std::string_view target = nextToken(line);
+		if(target.empty()) {
+			throw std::invalid_argument("Invalid edge in tgf file");
+		}
+		edges.emplace_back(getNewID(parseIdentifier(target)),
+		                   getNewID(parseIdentifier(source)));
+	}
+	if(edges.empty()) {
 		throw std::invalid_argument("No edges read from file, either # is missing, or there no edges encoded");
 	}
-	input.close();
+	Adjacency_.reset(NodeList_.size());
+	Adjacency_.addEdges(edges);
 }
 
 void Network::readSIF(const std::string& filename)
 {
-	std::string line;
-	unsigned int id1;
-	unsigned int id2;
-	std::string relation;
-	std::ifstream input(filename, std::ifstream::in);
-	if (! input.good()){
-		throw std::invalid_argument("File not found");
-		}
+	MappedFile file(filename);
 	if(NodeList_.empty())
 		throw std::invalid_argument(
 		    "You have to read in a .na file beforehand.");
-	while(std::getline(input, line)) {
-		std::stringstream buffer;
-		buffer << line;
-		buffer >> id1 >> relation >> id2;
-		if (relation == ""){
+	std::string_view content = file.getContent();
+	std::vector<AdjacencyList::Edge> edges;
+	edges.reserve(countLines(content));
+	while(!content.empty()) {
+		std::string_view line = nextLine(content);
+		std::string_view source = nextToken(line);
+		if(source.empty()) {
+			continue;
+		}
+		const unsigned int parent = getNewID(parseIdentifier(source));
+		std::string_view relation = nextToken(line);
+		std::string_view target = nextToken(line);
+		if(relation.empty() || target.empty()) {
 			throw std::invalid_argument("Invalid file structure of sif file");
 		}
-		addEdge(getNewID(id2), getNewID(id1));
-		relation = "";
+		// A line may list several targets sharing the same relation
+		for(; !target.empty(); target = nextToken(line)) {
+			edges.emplace_back(getNewID(parseIdentifier(target)), parent);
+		}
 	}
-	input.close();
+	Adjacency_.addEdges(edges);
 }
 
 void Network::readNA(const std::string& filename)
 {
-	NodeList_.clear();
-	AdjacencyMatrix_.clear();
-	std::string line;
-	std::ifstream input(filename, std::ifstream::in);
-	if (! input.good()){
-		throw std::invalid_argument("File not found");
+	MappedFile file(filename);
+	std::string_view content = file.getContent();
+	resetNodes(countLines(content));
+	// The first line contains the name of the attribute
+	nextLine(content);
+	while(!content.empty()) {
+		std::string_view line = nextLine(content);
+		std::string_view idToken = nextToken(line);
+		if(idToken.empty()) {
+			continue;
 		}
-	unsigned int id1;
-	std::string name = "";
-	std::string waste = "";
-	std::string ids;
-	unsigned int index = 0;
-	std::vector<std::string> names;
-	std::getline(input, line);
-	while(std::getline(input, line)) {
-		std::stringstream buffer;
-		buffer << line;
-		buffer >> id1 >> waste >> name;
-		if (waste == "" || name == "") {
+		std::string_view separator = nextToken(line);
+		std::string_view name = nextToken(line);
+		if(separator.empty() || name.empty()) {
 			throw std::invalid_argument("Invalid structure of na file");
 		}
-		id1=getDenseNodeIdentifier(id1);
-		NodeList_.push_back(Node(0, id1, name));
-		IDToIndex_[id1] = index;
-		NameToIndex_[name] = index;
-		std::stringstream nbuffer;
-		nbuffer << id1;
-		nbuffer >> ids;
-		names.push_back(ids);
-		index++;
-		waste = "";
-		name = "";
-	}
-	input.close();
-	AdjacencyMatrix_.resize(NodeList_.size(), NodeList_.size(), 0);
-	AdjacencyMatrix_.setRowNames(names);
-	AdjacencyMatrix_.setColNames(names);
-	std::sort(originalIDToDense_.begin(), originalIDToDense_.end(),Comp());
+		addNodeFromFile(parseIdentifier(idToken), name);
+	}
+	Adjacency_.reset(NodeList_.size());
+}
+
+void Network::readDot(const std::string& filename)
+{
+	MappedFile file(filename);
+	std::string_view content = file.getContent();
+	resetNodes(countLines(content));
+	std::vector<AdjacencyList::Edge> edges;
+	edges.reserve(countLines(content));
+
+	// The statements are processed while they are parsed, the buffer avoids
+	// an allocation per lookup of a known node
+	std::string name;
+	auto addNode = [this, &name](std::string_view identifier) {
+		name.assign(identifier);
+		auto it = NameToIndex_.find(name);
+		if(it != NameToIndex_.end()) {
+			return it->second;
+		}
+		const unsigned int id = NodeList_.size();
+		NameToIndex_.emplace(name, id);
+		NodeList_.emplace_back(0, id, name);
+		return id;
+	};
+	bool isDirected = false;
+	const bool parsed = Dot::Reader::parseStructure(
+	    content.data(), content.data() + content.size(), isDirected,
+	    [&addNode](std::string_view node) { addNode(node); },
+	    [&addNode, &edges](std::string_view source, std::string_view target) {
+		    const unsigned int parent = addNode(source);
+		    edges.emplace_back(addNode(target), parent);
+	    });
+	if(!parsed) {
+		throw std::invalid_argument("Invalid structure of dot file");
+	}
+	if(!isDirected) {
+		throw std::invalid_argument("Only directed graphs (digraph) are supported");
+	}
+	Adjacency_.reset(NodeList_.size());
+	Adjacency_.addEdges(edges);
+}
+
+void Network::resetNodes(size_t expectedSize)
+{
+	NodeList_.clear();
+	NameToIndex_.clear();
+	originalIDToDense_.clear();
+	Adjacency_.reset(0);
+	NodeList_.reserve(expectedSize);
+	NameToIndex_.reserve(expectedSize);
+	originalIDToDense_.reserve(expectedSize);
+}
+
+void Network::addNodeFromFile(unsigned int originalID, std::string_view name)
+{
+	const unsigned int id = getDenseNodeIdentifier(originalID);
+	std::string nodeName(name);
+	NameToIndex_[nodeName] = id;
+	NodeList_.emplace_back(0, id, std::move(nodeName));
 }
 
 void Network::assignParents()
@@ -310,45 +405,163 @@ void Network::performDFS(unsigned int id,
 	}
 }
 
-void Network::cycleCheck(unsigned int sourceID, unsigned int currentID, bool& result){
-	if (sourceID == currentID){
-		result = true;
+bool Network::isAncestor(unsigned int ancestorID, unsigned int id) const
+{
+	if(!ancestors_.empty()) {
+		return ancestors_[id][ancestorID];
 	}
-	else{
-		Node& n = getNode(currentID);
-		for (unsigned int pid : n.getParents()){
-			cycleCheck(sourceID,pid,result);
+	std::vector<char> visited(NodeList_.size(), 0);
+	std::vector<unsigned int> stack(1, id);
+	while(!stack.empty()) {
+		const unsigned int current = stack.back();
+		stack.pop_back();
+		for(auto pid : getNode(current).getParents()) {
+			if(pid == ancestorID) {
+				return true;
+			}
+			if(!visited[pid]) {
+				visited[pid] = 1;
+				stack.push_back(pid);
+			}
 		}
 	}
+	return false;
 }
 
-bool Network::checkCycleExistence(unsigned int id){
-	bool result = false;
-	Node& n = getNode(id);
-	for (int pid : n.getParents()){
-		cycleCheck(id,pid,result);
+bool Network::edgeInducesCycle(unsigned int id1, unsigned int id2) const
+{
+	return id1 == id2 || isAncestor(id1, id2);
+}
+
+bool Network::checkCycleExistence(unsigned int id) const
+{
+	return isAncestor(id, id);
+}
+
+bool Network::checkCycleExistence() const
+{
+	// white: not visited, grey: on the current DFS path, black: finished
+	enum Colour : char { white, grey, black };
+	std::vector<char> colour(NodeList_.size(), white);
+	// DFS stack holding the node and the position of the next parent to visit
+	std::vector<std::pair<unsigned int, unsigned int>> stack;
+	for(const auto& node : NodeList_) {
+		if(colour[node.getID()] != white) {
+			continue;
+		}
+		colour[node.getID()] = grey;
+		stack.emplace_back(node.getID(), 0);
+		while(!stack.empty()) {
+			auto& top = stack.back();
+			const auto& parents = getNode(top.first).getParents();
+			if(top.second == parents.size()) {
+				colour[top.first] = black;
+				stack.pop_back();
+				continue;
+			}
+			const unsigned int pid = parents[top.second++];
+			if(colour[pid] == grey) {
+				return true;
+			}
+			if(colour[pid] == white) {
+				colour[pid] = grey;
+				stack.emplace_back(pid, 0);
+			}
+		}
 	}
-	return result;
+	return false;
 }
 
-bool Network::checkCycleExistence(){
-	bool result = false;
-	for (auto& node : NodeList_){
-		result=checkCycleExistence(node.getID());
-		if (result){
-			return true;
+
+const std::vector<unsigned int>& Network::getTopologicalOrder() const
+{
+	if(topologicalOrder_.size() != NodeList_.size()) {
+		computeTopologicalOrder();
+	}
+	return topologicalOrder_;
+}
+
+unsigned int Network::getDepth(unsigned int id) const
+{
+	getTopologicalOrder();
+	return depth_[id];
+}
+
+const boost::dynamic_bitset<>& Network::getAncestors(unsigned int id) const
+{
+	if(ancestors_.size() != NodeList_.size()) {
+		const auto& order = getTopologicalOrder();
+		ancestors_.assign(NodeList_.size(),
+		                  boost::dynamic_bitset<>(NodeList_.size()));
+		// Parents precede their children, hence their sets are complete
+		for(auto current : order) {
+			auto& ancestors = ancestors_[current];
+			for(auto pid : getNode(current).getParents()) {
+				ancestors |= ancestors_[pid];
+				ancestors.set(pid);
+			}
 		}
 	}
-	return result;
+	return ancestors_[id];
 }
 
+void Network::invalidateStructureCache()
+{
+	topologicalOrder_.clear();
+	depth_.clear();
+	ancestors_.clear();
+}
 
-void Network::createBackup() { AdjacencyMatrixBackup_ = AdjacencyMatrix_; }
+void Network::computeTopologicalOrder() const
+{
+	std::vector<unsigned int> order;
+	order.reserve(NodeList_.size());
+	std::vector<unsigned int> depth(NodeList_.size(), 0);
+	// 0: not visited, 1: on the current DFS path, 2: finished
+	std::vector<char> state(NodeList_.size(), 0);
+	// DFS stack holding the node and the position of the next parent to visit
+	std::vector<std::pair<unsigned int, unsigned int>> stack;
+	for(const auto& node : NodeList_) {
+		if(state[node.getID()] != 0) {
+			continue;
+		}
+		state[node.getID()] = 1;
+		stack.emplace_back(node.getID(), 0);
+		while(!stack.empty()) {
+			auto& top = stack.back();
+			const auto& parents = getNode(top.first).getParents();
+			if(top.second == parents.size()) {
+				// All parents are finished, thus the node can be appended
+				const unsigned int current = top.first;
+				for(auto pid : parents) {
+					depth[current] = std::max(depth[current], depth[pid] + 1);
+				}
+				state[current] = 2;
+				order.push_back(current);
+				stack.pop_back();
+				continue;
+			}
+			const unsigned int pid = parents[top.second++];
+			if(state[pid] == 1) {
+				throw std::invalid_argument("The network contains a cycle");
+			}
+			if(state[pid] == 0) {
+				state[pid] = 1;
+				stack.emplace_back(pid, 0);
+			}
+		}
+	}
+	topologicalOrder_ = std::move(order);
+	depth_ = std::move(depth);
+}
+
+void Network::createBackup() { AdjacencyBackup_ = Adjacency_; }
 
 void Network::loadBackup()
 {
-	AdjacencyMatrix_ = AdjacencyMatrixBackup_;
-	AdjacencyMatrixBackup_ = Matrix<unsigned int>(0, 0, 0);
+	Adjacency_ = std::move(AdjacencyBackup_);
+	AdjacencyBackup_ = AdjacencyList();
+	invalidateStructureCache();
 }
 
 void Network::computeFactor(Node& n) const
@@ -361,24 +574,6 @@ void Network::computeFactor(Node& n) const
 	}
 }
 
-int Network::reverseFactor(Node& n, unsigned int i, int row)
-{
-	int value = row;
-	unsigned int temp = n.getRevFactor(row,i);
-	if (temp==0){
-		int result = -1;
-		for(unsigned int j = 0; j<= i; j++) {
-			int factor = n.getFactor(j);
-			result = value / factor;
-			value = (value % factor);
-			}
-		n.setRevFactor(result,row,i);
-		return result;
-		}
-	else
-		return temp;
-}
-
 bool Network::hasNode(const std::string& name) const
 {
 	return NameToIndex_.find(name) != NameToIndex_.end();
@@ -394,20 +589,21 @@ bool Network::hasValue(const std::string& nodeName,
 
 size_t Network::getDenseNodeIdentifier(unsigned int originialIdentifier)
 {
-	size_t newID = NodeList_.size();
-	originalIDToDense_.push_back(std::make_pair(originialIdentifier, newID));
+	const unsigned int newID = NodeList_.size();
+	if(!originalIDToDense_.emplace(originialIdentifier, newID).second) {
+		throw std::invalid_argument("Duplicate node identifier " +
+		                            std::to_string(originialIdentifier));
+	}
 	return newID;
 }
 
 unsigned int Network::getNewID(unsigned int originalIdentifier)
 {
-	auto low =
-	    std::lower_bound(originalIDToDense_.begin(), originalIDToDense_.end(),
-	                     originalIdentifier, Comp());
-	if(low != originalIDToDense_.end()) {
-		return low->second;
+	auto res = originalIDToDense_.find(originalIdentifier);
+	if(res == originalIDToDense_.end()) {
+		throw std::invalid_argument("Identifier not found");
 	}
-	throw std::invalid_argument("Identifier not found");
+	return res->second;
 }
 
 size_t Network::size() const { return getNodes().size(); }
@@ -426,11 +622,11 @@ void Network::saveParameters() const{
 		for (size_t row = 0; row < rowCount; row++)
 			for (size_t col = 0; col < colCount; col++){
 				file<<n.getName()<<"\t";
-				file<<n.getProbabilityMatrix().getColNames()[col]<<"\t";
+				file<<n.getValueNamesProb()[col]<<"\t";
 				for (auto& id : parents){
 					file<<getNode(id).getName()<<"\t";
 				}
-				file<<n.getProbabilityMatrix().getRowNames()[row]<<"\t";
+				file<<n.getParentValueName(row)<<"\t";
 				file<<n.getProbability(col,row)<<"\n";
 			}
 		}
@@ -445,6 +641,7 @@ void Network::clearDynProgMatrices(){
 
 void Network::removeHypoNodes(){
 	NodeList_.erase(NodeList_.begin()+hypostart_,NodeList_.end());
+	invalidateStructureCache();
 }
 
 void Network::createTwinNetwork(){
@@ -478,11 +675,11 @@ void Network::createTwinNetwork(){
 			}
 		}
 		hypoNode.setParents(newParents);
-		IDToIndex_[hypoNode.getID()] = index;
 		NameToIndex_[hypoNode.getName()] = index;
 		index++;	
 		NodeList_.push_back(hypoNode);
 	}
+	invalidateStructureCache();
 }
 
 unsigned int Network::getHypoStart(){
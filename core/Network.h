@@ -1,8 +1,13 @@
 #ifndef NETWORK_H
 #define NETWORK_H
 
+#include "AdjacencyList.h"
+#include "Matrix.h"
 #include "Node.h"
 #include <map>
+#include <string_view>
+
+#include <boost/dynamic_bitset.hpp>
 
 class Network{
 	public:
@@ -19,10 +24,23 @@ class Network{
 		 * @param filename File containing the structural information of the network
 		 *
 		 * Depending on the type of the file to read, this method calls the
-		 * appropriate reading methods. SIF, NA and TGF files are supported.
+		 * appropriate reading methods. SIF, NA, TGF and DOT files are supported.
 		 */
 		void readNetwork(const std::string& filename);
 
+		/**createNetwork
+		 *
+		 * @param names Names of the nodes, the position is used as identifier
+		 * @param edges Edges given as pairs (child, parent) of identifiers
+		 *
+		 * Replaces the structure of the network by the given one, e.g. for
+		 * networks that are generated instead of read from a file.
+		 *
+		 * @throw invalid_argument if the structure contains a cycle
+		 */
+		void createNetwork(const std::vector<std::string>& names,
+		                   const std::vector<AdjacencyList::Edge>& edges);
+
 		/**cutParents 
 		 *
 		 * @param id Identifier of the node upon which the parent removal operation
@@ -92,15 +110,27 @@ class Network{
 		 */
 		void performDFS(unsigned int id, std::vector<unsigned int>& visitedNodes);
 
-		/**cycleCheck 
+		/**isAncestor
 		 *
-		 * @param sourceID Identifier of the cycle start node
-		 * @param currentID Identifier of the current node
-		 * @param result Variable holding the result whether or not there is a cycle
+		 * @param ancestorID Identifier of the potential ancestor
+		 * @param id Identifier of the node whose ancestors are searched
+		 * @return true if ancestorID can be reached from id by following parent edges
 		 *
-		 * Performs Depth First Search in the network starting from the given node.
+		 * Uses the cached ancestor sets if available, otherwise performs an
+		 * iterative Depth First Search visiting every ancestor at most once.
+		 */
+		bool isAncestor(unsigned int ancestorID, unsigned int id) const;
+
+		/**edgeInducesCycle
+		 *
+		 * @param id1 Identifier of the node that would get the new parent
+		 * @param id2 Identifier of the new parent
+		 * @return true if adding the edge with addEdge(id1, id2) would close a cycle
+		 *
+		 * Incremental acyclicity check for a single edge in an acyclic network,
+		 * only the ancestors of id2 are visited.
 		 */
-		void cycleCheck(unsigned int sourceID, unsigned int currentID, bool& result);
+		bool edgeInducesCycle(unsigned int id1, unsigned int id2) const;
 
 		/**checkCycleExistence
 		 *
@@ -109,15 +139,52 @@ class Network{
 		 *
 		 * Checks if there is a cycle so that this node can be reached from itself.
 		 */
-		bool checkCycleExistence(unsigned int id);
+		bool checkCycleExistence(unsigned int id) const;
 
 		/**checkCycleExistence
 		 *
 		 * @return true if there is a cycle, false otherwise
 		 *
-		 * Checks if there is a cycle in this network.
+		 * Checks if there is a cycle in this network using a colouring Depth
+		 * First Search, which runs in linear time with respect to nodes and edges.
+		 */
+		bool checkCycleExistence() const;
+
+		/**getTopologicalOrder
+		 *
+		 * @return identifiers of all nodes ordered such that parents precede their children
+		 *
+		 * The order is computed from the parents of the nodes on first use and
+		 * cached until the structure changes.
+		 *
+		 * @throw invalid_argument if the network contains a cycle
+		 */
+		const std::vector<unsigned int>& getTopologicalOrder() const;
+
+		/**getDepth
+		 *
+		 * @param id Identifier of a node
+		 * @return length of the longest path from a root to the node, 0 for roots
+		 */
+		unsigned int getDepth(unsigned int id) const;
+
+		/**getAncestors
+		 *
+		 * @param id Identifier of a node
+		 * @return bitset with one bit per node identifier, set for all ancestors of the node
+		 *
+		 * The ancestor sets of all nodes are computed on first use and cached
+		 * until the structure changes.
 		 */
-		bool checkCycleExistence();
+		const boost::dynamic_bitset<>& getAncestors(unsigned int id) const;
+
+		/**invalidateStructureCache
+		 *
+		 * Discards the cached topological order, depths and ancestor sets. Has
+		 * to be called whenever parents of nodes are changed without using
+		 * the methods of this class.
+		 */
+		void invalidateStructureCache();
 
 		/**getNode 
 		 *
@@ -268,19 +335,6 @@ class Network{
 		 */
 		void computeFactor(Node& n) const ;
 
-		/**reverseFactor 
-		 *
-		 * @param n A reference to the node of interest
-		 * @param position of the parent in question in the parent list of n
-		 * @param row Row of the probability matrix in which the factor occures
-		 *
-		 * @return The original value of the given node
-		 *
-		 * Calculates the original value of a node given the dense integer
-		 * representation used for internal storage
-		 */
-		int reverseFactor(Node& n, unsigned int i, int row);
-
 		/**size 
 		 *
 		 * @return Returns the number of nodes in network
@@ -387,9 +441,28 @@ class Network{
 		 * @return A dense node identifier
 		 *
 		 * Creates a dense node identifier, given the original one
+		 *
+		 * @throw invalid_argument if the original identifier is already in use
 		 */
 		size_t getDenseNodeIdentifier(unsigned int originialIdentifier);
 
+		/**resetNodes
+		 *
+		 * @param expectedSize Expected number of nodes, used to reserve memory
+		 *
+		 * Removes all nodes, names and identifier mappings before reading a network
+		 */
+		void resetNodes(size_t expectedSize);
+
+		/**addNodeFromFile
+		 *
+		 * @param originalID The identifier from the network file
+		 * @param name The name of the node
+		 *
+		 * Appends a new node with a dense identifier to the node list
+		 */
+		void addNodeFromFile(unsigned int originalID, std::string_view name);
+
 		/**assignParents 
 		 *
 		 * Calls the private getParents method in this class for every Node
@@ -424,11 +497,24 @@ class Network{
 		 */
 		void readNA(const std::string& filename);
 
-		//Matrices to store the network structure
-		Matrix<unsigned int> AdjacencyMatrix_;
-		Matrix<unsigned int> AdjacencyMatrixBackup_;
-		//Maps the identifier of a node to its index in the NodeList_
-		std::unordered_map<unsigned int, unsigned int> IDToIndex_;
+		/**readDot
+		 *
+		 * @param filename Name of the DOT file
+		 *
+		 * Reads a directed graph in the DOT language. The DOT node identifiers
+		 * are used as node names, edges point from the parent to the child.
+		 */
+		void readDot(const std::string& filename);
+
+		/**computeTopologicalOrder
+		 *
+		 * Fills the cached topological order and depths
+		 */
+		void computeTopologicalOrder() const;
+
+		//Parent and child lists storing the network structure
+		AdjacencyList Adjacency_;
+		AdjacencyList AdjacencyBackup_;
 		//Maps the name of a node to its index int the NodeList_
 		std::unordered_map<std::string, unsigned int> NameToIndex_;
 		//Depending on the file typ, an unsigned int is returned to allow for switching
@@ -436,13 +522,18 @@ class Network{
 		//Maps the original name of an observation to the internal integer representation
 		std::unordered_map<std::string,int> observationsMap_;
 		//Maps the original identifiers to the internally used dense identifiers
-		std::vector<std::pair<unsigned int, unsigned int>> originalIDToDense_;
+		std::unordered_map<unsigned int, unsigned int> originalIDToDense_;
 		//Maps the internal integer value representation to the original values
 		std::map<std::pair<int,int>, std::string> observationsMapR_;
 		//Stores the nodes of the network
 		std::vector<Node> NodeList_;
 		//Stores the startindex of the hypothetical nodes
 		unsigned int hypostart_;
+		//Cached topological order and depth per node, empty if invalid
+		mutable std::vector<unsigned int> topologicalOrder_;
+		mutable std::vector<unsigned int> depth_;
+		//Cached ancestor set per node, empty if invalid
+		mutable std::vector<boost::dynamic_bitset<>> ancestors_;
 		//Mapes the original Node ID to the hypothetical node ID
 		std::vector<unsigned int> IDMap_;
 };
@@ -4,18 +4,28 @@
 #include "Discretiser.h"
 #include "DiscretisationSettings.h"
 #include "EM.h"
+#include "ObservationStream.h"
+#include "Trace.h"
+#include <algorithm>
+#include <cmath>
 #include <fstream>
+#include <utility>
 NetworkController::NetworkController()
-    : observations_(0, 0, -1),
-      eMRuns_(0),
+    : eMRuns_(0),
       finalDifference_(0),
       likelihoodOfTheData_(0.0f),
-      timeInMicroSeconds_(0)
+      timeInMicroSeconds_(0),
+      forgettingFactor_(1.0),
+      weightScale_(1.0)
 {
+	eMSettings_.differenceThreshold = 0.001f;
+	eMSettings_.maxRuns = 100000;
 }
 
 void NetworkController::loadNetwork(const std::string& networkfile){
+	CT_TRACE_SCOPE("NetworkController::loadNetwork");
 	network_.readNetwork(networkfile);
+	sampleWeights_.clear();
 }
 
 Network& NetworkController::getNetwork(){
@@ -29,24 +39,29 @@ const Network& NetworkController::getNetwork() const {
 void NetworkController::loadObservations(const std::string& datafile,
                                          const std::string& controlFile)
 {
+	CT_TRACE_SCOPE("NetworkController::loadObservations");
 	Matrix<std::string> originalObservations(datafile, false, true);
-	Discretiser d(originalObservations,controlFile,observations_,network_);
+	Discretiser d(std::move(originalObservations), controlFile, observations_,
+	              network_);
 }
 
 void NetworkController::loadObservations(
     const std::string& datafile, const std::string& controlFile,
     const std::vector<unsigned int>& samplesToDelete)
 {
+	CT_TRACE_SCOPE("NetworkController::loadObservations");
 	Matrix<std::string> originalObservations(datafile, false, true,samplesToDelete);
-	Discretiser d(originalObservations,controlFile,observations_,network_);
+	Discretiser d(std::move(originalObservations), controlFile, observations_,
+	              network_);
 }
 
 void NetworkController::loadObservations(
 	const std::string& datafile, 
 	const DiscretisationSettings& propertyTree)
 {
+	CT_TRACE_SCOPE("NetworkController::loadObservations");
 	Matrix<std::string> originalObservations(datafile, false, true);
-	Discretiser d(originalObservations,observations_,network_);
+	Discretiser d(std::move(originalObservations), observations_, network_);
 	d.setJsonTree(propertyTree);
 	d.discretise();
 }
@@ -56,8 +71,9 @@ void NetworkController::loadObservations(
 	const DiscretisationSettings& propertyTree,
 	const std::vector<unsigned int>& samplesToDelete)
 {
+	CT_TRACE_SCOPE("NetworkController::loadObservations");
 	Matrix<std::string> originalObservations(datafile, false, true,samplesToDelete);
-	Discretiser d(originalObservations,observations_,network_);
+	Discretiser d(std::move(originalObservations), observations_, network_);
 	d.setJsonTree(propertyTree);
 	d.discretise();
 }
@@ -65,16 +81,81 @@ void NetworkController::loadObservations(
 
 
 void NetworkController::trainNetwork(){
+	CT_TRACE_SCOPE("NetworkController::trainNetwork");
 	DataDistribution datadu(network_, observations_);
 	storeDiscretisedData("discretisedData.txt");
 	datadu.assignObservationsToNodes();
 	datadu.distributeObservations();
-	EM em(network_, observations_, 0.001f, 100000);
+	EM em(network_, observations_, eMSettings_);
 	eMRuns_ = em.getNumberOfRuns();
 	finalDifference_ = em.getDifference();
 	likelihoodOfTheData_ = em.calculateLikelihoodOfTheData();
 	timeInMicroSeconds_ = em.getTimeInMicroSeconds();
+	eMIterationStats_ = em.getIterationStats();
 	network_.clearDynProgMatrices();
+	sampleWeights_.clear();
+}
+
+void NetworkController::trainNetworkFromFile(
+    const std::string& datafile, const DiscretisationSettings& settings,
+    unsigned int chunkSize)
+{
+	CT_TRACE_SCOPE("NetworkController::trainNetworkFromFile");
+	if(chunkSize == 0) {
+		throw std::invalid_argument("The chunk size has to be positive");
+	}
+	ObservationStream stream(datafile, settings, network_);
+	const unsigned int sampleCount = stream.getSampleCount();
+	if(sampleCount == 0) {
+		throw std::invalid_argument("No samples provided");
+	}
+
+	ObservationCodes chunk;
+	DataDistribution datadu(network_, chunk);
+	datadu.assignObservationsToNodes(stream.getRowNames(),
+	                                 stream.getUniqueValues());
+	datadu.createMatrices();
+	for(unsigned int first = 0; first < sampleCount; first += chunkSize) {
+		stream.readSamples(first, std::min(chunkSize, sampleCount - first),
+		                   chunk);
+		datadu.countObservations();
+	}
+
+	EM em(network_, eMSettings_);
+	eMRuns_ = em.getNumberOfRuns();
+	finalDifference_ = em.getDifference();
+	timeInMicroSeconds_ = em.getTimeInMicroSeconds();
+	eMIterationStats_ = em.getIterationStats();
+
+	// The likelihood of the data needs a second pass over the samples
+	ProbabilityHandler probHandler(network_);
+	float probability = 0.0f;
+	for(unsigned int first = 0; first < sampleCount; first += chunkSize) {
+		stream.readSamples(first, std::min(chunkSize, sampleCount - first),
+		                   chunk);
+		probability += probHandler.calculateProbabilityOfTheSamples(chunk);
+	}
+	likelihoodOfTheData_ = std::log(probability);
+
+	observations_ = ObservationCodes(0, stream.getRowNames(), -1);
+	network_.clearDynProgMatrices();
+	sampleWeights_.clear();
+}
+
+void NetworkController::trainNetworkFromFile(const std::string& datafile,
+                                             const std::string& controlFile,
+                                             unsigned int chunkSize)
+{
+	trainNetworkFromFile(datafile, DiscretisationSettings(controlFile),
+	                     chunkSize);
+}
+
+void NetworkController::setEMSettings(const EMSettings& settings) {
+	eMSettings_ = settings;
+}
+
+const EMSettings& NetworkController::getEMSettings() const {
+	return eMSettings_;
 }
 
 float NetworkController::getLikelihoodOfTheData() const {
@@ -93,6 +174,10 @@ int NetworkController::getTimeInMicroSeconds() const {
 	return timeInMicroSeconds_;
 }
 
+const std::vector<EMIterationStats>& NetworkController::getEMIterationStats() const {
+	return eMIterationStats_;
+}
+
 void NetworkController::saveParameters() const{
 	network_.saveParameters();
 }
@@ -107,9 +192,7 @@ bool NetworkController::isEdgePossible(unsigned int sourceID, unsigned int targe
 	for (auto& pair : removedEdges){
 		network_.removeEdge(pair.second,pair.first);
 	}
-	network_.addEdge(targetID,sourceID);
-	bool edgePossible = !network_.checkCycleExistence(sourceID);
-	network_.removeEdge(targetID,sourceID);
+	bool edgePossible = !network_.edgeInducesCycle(targetID,sourceID);
 	for (auto& pair : removedEdges){
 		network_.addEdge(pair.second,pair.first);
 	}
@@ -125,3 +208,119 @@ void NetworkController::storeDiscretisedData(const std::string& filename) const{
 	f << observations_<<std::endl;
 	f.close();
 }
+
+QueryArena& NetworkController::getQueryArena() { return queryArena_; }
+
+const ObservationCodes& NetworkController::getObservations() const {
+	return observations_;
+}
+
+void NetworkController::setForgettingFactor(double factor) {
+	if(!(factor > 0.0 && factor <= 1.0)) {
+		throw std::invalid_argument("The forgetting factor has to be in (0, 1]");
+	}
+	forgettingFactor_ = factor;
+}
+
+double NetworkController::getForgettingFactor() const {
+	return forgettingFactor_;
+}
+
+void NetworkController::initialiseSampleWeights() {
+	const auto& nodes = network_.getNodes();
+	sampleWeights_.resize(nodes.size());
+	weightScale_ = 1.0;
+	for(size_t i = 0; i < nodes.size(); i++) {
+		const Table<int>& obMatrix = nodes[i].getObservationMatrix();
+		Table<double>& weights = sampleWeights_[i];
+		weights.assign(obMatrix.getColCount(), obMatrix.getRowCount(), 0.0);
+		for(unsigned int row = 0; row < obMatrix.getRowCount(); row++) {
+			for(unsigned int col = 0; col < obMatrix.getColCount(); col++) {
+				weights(col, row) = obMatrix(col, row);
+			}
+		}
+	}
+}
+
+void NetworkController::addSamples(const Matrix<int>& samples) {
+	addSamples(ObservationCodes(samples));
+}
+
+void NetworkController::addSamples(const ObservationCodes& samples) {
+	CT_TRACE_SCOPE("NetworkController::addSamples");
+	if(samples.getRowCount() != observations_.getRowCount()) {
+		throw std::invalid_argument(
+		    "The samples have to contain the same rows as the observations");
+	}
+	auto& nodes = network_.getNodes();
+	// Check all samples first, such that a failure leaves the network intact
+	for(const Node& n : nodes) {
+		const int valueCount = n.getNumberOfUniqueValuesExcludingNA();
+		for(unsigned int sample = 0; sample < samples.getColCount(); sample++) {
+			const int value = samples(sample, n.getObservationRow());
+			if(value < -1 || value >= valueCount) {
+				throw std::invalid_argument("Unknown value " +
+				                            std::to_string(value) +
+				                            " of node " + n.getName());
+			}
+		}
+	}
+	if(sampleWeights_.size() != nodes.size()) {
+		initialiseSampleWeights();
+	}
+
+	for(unsigned int sample = 0; sample < samples.getColCount(); sample++) {
+		// Decaying the previous weights is equivalent to raising the weight
+		// of the new sample
+		weightScale_ *= forgettingFactor_;
+		if(weightScale_ < 1e-100) {
+			for(auto& weights : sampleWeights_) {
+				for(unsigned int row = 0; row < weights.getRowCount(); row++) {
+					for(unsigned int col = 0; col < weights.getColCount(); col++) {
+						weights(col, row) *= weightScale_;
+					}
+				}
+			}
+			weightScale_ = 1.0;
+		}
+		const double weight = 1.0 / weightScale_;
+		for(size_t i = 0; i < nodes.size(); i++) {
+			Node& n = nodes[i];
+			unsigned int row = 0;
+			bool parentsObserved = true;
+			const auto& parents = n.getParents();
+			for(unsigned int p = 0; p < parents.size(); p++) {
+				const int value = samples(
+				    sample, network_.getNode(parents[p]).getObservationRow());
+				if(value == -1) {
+					parentsObserved = false;
+					break;
+				}
+				row += n.getFactor(p) * value;
+			}
+			const int value = samples(sample, n.getObservationRow());
+			// Missing values are only counted if the node had some before
+			if(!parentsObserved || (value == -1 && !n.hasNA())) {
+				continue;
+			}
+			const unsigned int offset = n.hasNA() ? 1 : 0;
+			const unsigned int col = value + offset;
+			n.getObservationMatrix()(col, row)++;
+			Table<double>& weights = sampleWeights_[i];
+			weights(col, row) += weight;
+			if(value == -1) {
+				// A missing value does not change the maximum likelihood
+				// estimate, which is the fixed point of EM
+				continue;
+			}
+			double total = 0.0;
+			for(unsigned int c = offset; c < weights.getColCount(); c++) {
+				total += weights(c, row);
+			}
+			for(unsigned int c = offset; c < weights.getColCount(); c++) {
+				n.setProbability(weights(c, row) / total, c - offset, row);
+			}
+		}
+	}
+	network_.clearDynProgMatrices();
+}
@@ -1,8 +1,12 @@
 #ifndef NETWORKCONTROLLER_H
 #define NETWORKCONTROLLER_H
 
+#include "EMSettings.h"
 #include "Matrix.h"
 #include "Network.h"
+#include "ObservationCodes.h"
+#include "Profiling.h"
+#include "QueryArena.h"
 
 #include <string>
 #include <vector>
@@ -78,6 +82,44 @@ class NetworkController
 	 */
 	void trainNetwork();
 
+	/**
+	 * Discretises the raw sample data and trains the network without holding
+	 * the observations in memory. The file is discretised row by row into a
+	 * temporary file, from which the node counts and the likelihood of the
+	 * data are accumulated chunk by chunk. Memory is bounded by a single row
+	 * of raw values and a chunk of discretised samples. Afterwards, the
+	 * observations only contain the row names.
+	 *
+	 * @param datafile File containing the raw sample data.
+	 * @param settings Parameters used for discretisation.
+	 * @param chunkSize Number of samples read at a time.
+	 *
+	 * @throw invalid_argument if the chunk size is zero or the file does not
+	 *        contain any samples
+	 */
+	void trainNetworkFromFile(const std::string& datafile,
+	                          const DiscretisationSettings& settings,
+	                          unsigned int chunkSize = 4096);
+
+	/**
+	 * @param datafile File containing the raw sample data.
+	 * @param controlFile File containing the discretiser parameters.
+	 * @param chunkSize Number of samples read at a time.
+	 */
+	void trainNetworkFromFile(const std::string& datafile,
+	                          const std::string& controlFile,
+	                          unsigned int chunkSize = 4096);
+
+	/**
+	 * @param settings Parameters of the EM algorithm used by trainNetwork
+	 */
+	void setEMSettings(const EMSettings& settings);
+
+	/**
+	 * @return the parameters of the EM algorithm used by trainNetwork
+	 */
+	const EMSettings& getEMSettings() const;
+
 	/**
 	 * @return the log-likelihood of the data
 	 */
@@ -108,6 +150,12 @@ class NetworkController
 	 */
 	int getTimeInMicroSeconds() const;
 
+	/**
+	 * @return duration and parameter difference of each EM iteration of the
+	 * last training. Only recorded if built with CAUSALTRAIL_PROFILING.
+	 */
+	const std::vector<EMIterationStats>& getEMIterationStats() const;
+
 	/**
 	 * Stores all network parameters in a file.
 	 * The filename incorporates the data and time of its generation
@@ -133,13 +181,79 @@ class NetworkController
 	 * @param filename Name of the file to write the discretised data to
 	 */
 	void storeDiscretisedData(const std::string& filename) const;	
+
+	/**getQueryArena
+	 *
+	 * @return the memory arena shared by all queries on this network
+	 */
+	QueryArena& getQueryArena();
+
+	/**getObservations
+	 *
+	 * @return the discretised observations, one column per sample
+	 */
+	const ObservationCodes& getObservations() const;
+
+	/**addSamples
+	 *
+	 * Appends discretised samples to the trained network. The observation
+	 * counts of the nodes and the CPT rows the samples fall into are updated
+	 * incrementally, hence the cost is linear in the number of new samples.
+	 * As for training, a sample only counts for a node if all parents of the
+	 * node are observed. The samples are not added to the observations used
+	 * by trainNetwork.
+	 *
+	 * @param samples Discretised samples, one column per sample and the rows
+	 *                as in the loaded observations. -1 denotes a missing value.
+	 *
+	 * @throw invalid_argument if the rows do not match the observations or a
+	 *        sample contains a value unknown to its node
+	 */
+	void addSamples(const ObservationCodes& samples);
+
+	/**addSamples
+	 *
+	 * @param samples Discretised samples, one column per sample and the rows
+	 *                as in the loaded observations. -1 denotes a missing value.
+	 *
+	 * @throw invalid_argument if the rows do not match the observations or a
+	 *        sample contains a value unknown to its node
+	 */
+	void addSamples(const Matrix<int>& samples);
+
+	/**setForgettingFactor
+	 *
+	 * @param factor Weight of the previous samples relative to a new sample,
+	 *               in (0, 1]. The CPTs are estimated from the exponentially
+	 *               weighted counts, the observation counts of the nodes stay
+	 *               unweighted. 1 disables forgetting.
+	 *
+	 * @throw invalid_argument if the factor is not in (0, 1]
+	 */
+	void setForgettingFactor(double factor);
+
+	/**getForgettingFactor
+	 *
+	 * @return weight of the previous samples relative to a new sample
+	 */
+	double getForgettingFactor() const;
+
 	private:
+	/**initialiseSampleWeights
+	 *
+	 * Initialises the weighted counts used by addSamples with the observation
+	 * counts of the trained network.
+	 */
+	void initialiseSampleWeights();
 
 	//Network object
 	Network network_;
 
-	//Matrix containing the discretised observations
-	Matrix<int> observations_;
+	//The discretised observations
+	ObservationCodes observations_;
+
+	//Parameters of the EM algorithm
+	EMSettings eMSettings_;
 
 	//Number of EM runs
 	int eMRuns_;
@@ -152,6 +266,21 @@ class NetworkController
 
 	//Time in microseconds to perform EM
 	int timeInMicroSeconds_;
+
+	//Per iteration statistics of the last EM run
+	std::vector<EMIterationStats> eMIterationStats_;
+
+	//Memory arena reused by all queries, such that its buffer persists
+	QueryArena queryArena_;
+
+	//Weight of the previous samples relative to a new sample
+	double forgettingFactor_;
+
+	//Exponentially weighted counts of every node, laid out like its
+	//observation matrix. The actual weights are the entries times
+	//weightScale_, such that forgetting does not touch every entry.
+	std::vector<Table<double>> sampleWeights_;
+	double weightScale_;
 };
 
 #endif
@@ -0,0 +1,162 @@
+#include "NetworkGenerator.h"
+#include "DiscretisationSettings.h"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+NetworkGenerator::NetworkGenerator(const GeneratorSettings& settings)
+    : settings_(settings), generator_(settings.seed)
+{
+	if(settings_.nodes == 0) {
+		throw std::invalid_argument("The network needs at least one node");
+	}
+	if(settings_.minCardinality < 2 ||
+	   settings_.minCardinality > settings_.maxCardinality ||
+	   settings_.maxCardinality > std::numeric_limits<uint16_t>::max()) {
+		throw std::invalid_argument("Invalid range of node cardinalities");
+	}
+
+	std::vector<std::string> names;
+	names.reserve(settings_.nodes);
+	std::vector<AdjacencyList::Edge> edges;
+	std::uniform_int_distribution<unsigned int> cardinality(
+	    settings_.minCardinality, settings_.maxCardinality);
+	std::uniform_int_distribution<unsigned int> parentCount(
+	    0, settings_.maxParents);
+	std::vector<unsigned int> candidates;
+	for(unsigned int id = 0; id < settings_.nodes; id++) {
+		names.push_back("N" + std::to_string(id));
+		cardinalities_.push_back(cardinality(generator_));
+
+		// Candidates are the predecessors inside the treewidth window
+		const unsigned int first =
+		    (settings_.treewidth == 0 || id < settings_.treewidth)
+		        ? 0
+		        : id - settings_.treewidth;
+		candidates.clear();
+		for(unsigned int parent = first; parent < id; parent++) {
+			candidates.push_back(parent);
+		}
+		std::shuffle(candidates.begin(), candidates.end(), generator_);
+		const unsigned int count = std::min<unsigned int>(
+		    parentCount(generator_), candidates.size());
+		for(unsigned int i = 0; i < count; i++) {
+			edges.emplace_back(id, candidates[i]);
+		}
+	}
+	network_.createNetwork(names, edges);
+
+	std::uniform_real_distribution<float> weight(0.05f, 1.0f);
+	probabilities_.reserve(settings_.nodes);
+	for(unsigned int id = 0; id < settings_.nodes; id++) {
+		size_t rows = 1;
+		for(auto parent : network_.getNode(id).getParents()) {
+			rows *= cardinalities_[parent];
+		}
+		Table<float> table(cardinalities_[id], rows);
+		for(unsigned int row = 0; row < rows; row++) {
+			float sum = 0.0f;
+			for(unsigned int col = 0; col < cardinalities_[id]; col++) {
+				table(col, row) = weight(generator_);
+				sum += table(col, row);
+			}
+			for(unsigned int col = 0; col < cardinalities_[id]; col++) {
+				table(col, row) /= sum;
+			}
+		}
+		probabilities_.push_back(std::move(table));
+	}
+}
+
+const Network& NetworkGenerator::getNetwork() const { return network_; }
+
+unsigned int NetworkGenerator::getCardinality(unsigned int id) const
+{
+	return cardinalities_[id];
+}
+
+const Table<float>& NetworkGenerator::getProbabilities(unsigned int id) const
+{
+	return probabilities_[id];
+}
+
+Table<uint16_t> NetworkGenerator::sample(unsigned int samples)
+{
+	Table<uint16_t> values(samples, settings_.nodes);
+	std::uniform_real_distribution<float> uniform(0.0f, 1.0f);
+	const auto& order = network_.getTopologicalOrder();
+	for(unsigned int sample = 0; sample < samples; sample++) {
+		for(auto id : order) {
+			size_t row = 0;
+			for(auto parent : network_.getNode(id).getParents()) {
+				row = row * cardinalities_[parent] + values(sample, parent);
+			}
+			const Table<float>& table = probabilities_[id];
+			float draw = uniform(generator_);
+			uint16_t value = 0;
+			while(value + 1u < cardinalities_[id] && draw >= table(value, row)) {
+				draw -= table(value, row);
+				value++;
+			}
+			values(sample, id) = value;
+		}
+	}
+	return values;
+}
+
+void NetworkGenerator::writeNetwork(const std::string& filename) const
+{
+	bool hasEdges = false;
+	for(const auto& node : network_.getNodes()) {
+		hasEdges = hasEdges || !node.getParents().empty();
+	}
+	if(!hasEdges) {
+		throw std::invalid_argument("A TGF file requires at least one edge");
+	}
+	std::ofstream output(filename);
+	if(!output.good()) {
+		throw std::invalid_argument("Cannot write file '" + filename + "'");
+	}
+	for(const auto& node : network_.getNodes()) {
+		output << node.getID() << "\t" << node.getName() << "\n";
+	}
+	output << "#\n";
+	for(const auto& node : network_.getNodes()) {
+		for(auto parent : node.getParents()) {
+			output << parent << " " << node.getID() << "\n";
+		}
+	}
+}
+
+void NetworkGenerator::writeObservations(const std::string& filename,
+                                         unsigned int samples, float naRate)
+{
+	std::ofstream output(filename);
+	if(!output.good()) {
+		throw std::invalid_argument("Cannot write file '" + filename + "'");
+	}
+	const Table<uint16_t> values = sample(samples);
+	std::bernoulli_distribution isNA(naRate);
+	for(const auto& node : network_.getNodes()) {
+		output << node.getName();
+		for(unsigned int sample = 0; sample < samples; sample++) {
+			if(isNA(generator_)) {
+				output << "\tNA";
+			} else {
+				output << "\tv" << values(sample, node.getID());
+			}
+		}
+		output << "\n";
+	}
+}
+
+void NetworkGenerator::writeDiscretisation(const std::string& filename) const
+{
+	DiscretisationSettings settings;
+	for(const auto& node : network_.getNodes()) {
+		settings.addToTree(node.getName(), "None");
+	}
+	settings.exportToFile(filename);
+}
@@ -0,0 +1,125 @@
+#ifndef NETWORKGENERATOR_H
+#define NETWORKGENERATOR_H
+
+#include "Network.h"
+#include "Table.h"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Parameters of a randomly generated network
+ */
+struct GeneratorSettings
+{
+	// Number of nodes
+	unsigned int nodes = 100;
+	// Maximal number of parents of a node
+	unsigned int maxParents = 3;
+	// Range of the number of values per node
+	unsigned int minCardinality = 2;
+	unsigned int maxCardinality = 3;
+	// Parents of a node are chosen among its treewidth predecessors, which
+	// bounds the treewidth of the moral graph. 0 means unbounded.
+	unsigned int treewidth = 0;
+	// Seed of the random number generator
+	unsigned int seed = 42;
+};
+
+/**
+ * Generates random causal Bayesian networks together with samples drawn from
+ * them, e.g. to provide reproducible large inputs for benchmarks and tests.
+ * Nodes are named N0, N1, ... and their values v0, v1, ...
+ */
+class NetworkGenerator
+{
+	public:
+	/**NetworkGenerator
+	 *
+	 * @param settings, parameters of the network
+	 *
+	 * @return a NetworkGenerator holding a random structure and random
+	 * conditional probability tables
+	 *
+	 * @throw invalid_argument if the settings are inconsistent
+	 */
+	explicit NetworkGenerator(const GeneratorSettings& settings);
+
+	/**getNetwork
+	 *
+	 * @return the generated structure
+	 */
+	const Network& getNetwork() const;
+
+	/**getCardinality
+	 *
+	 * @param id, identifier of a node
+	 *
+	 * @return the number of values of the node
+	 */
+	unsigned int getCardinality(unsigned int id) const;
+
+	/**getProbabilities
+	 *
+	 * @param id, identifier of a node
+	 *
+	 * @return the conditional probability table of the node. The columns are
+	 * the values of the node, the rows the parent combinations, the value of
+	 * the last parent changing fastest.
+	 */
+	const Table<float>& getProbabilities(unsigned int id) const;
+
+	/**sample
+	 *
+	 * @param samples, number of samples to draw
+	 *
+	 * @return table of value indices with one column per sample and one row
+	 * per node, drawn by forward sampling
+	 */
+	Table<uint16_t> sample(unsigned int samples);
+
+	/**writeNetwork
+	 *
+	 * @param filename, name of the TGF file to be written
+	 *
+	 * @throw invalid_argument if the network has no edges, as such a file
+	 * could not be read
+	 */
+	void writeNetwork(const std::string& filename) const;
+
+	/**writeObservations
+	 *
+	 * @param filename, name of the observation file to be written
+	 * @param samples, number of samples to draw
+	 * @param naRate, fraction of the observations replaced by NA
+	 *
+	 * Writes samples in the format read by Matrix<std::string>, one row per
+	 * node starting with the node name.
+	 */
+	void writeObservations(const std::string& filename, unsigned int samples,
+	                       float naRate = 0.0f);
+
+	/**writeDiscretisation
+	 *
+	 * @param filename, name of the discretisation control file to be written
+	 *
+	 * The method "None" is used for all nodes, as the values are categorical.
+	 */
+	void writeDiscretisation(const std::string& filename) const;
+
+	private:
+	// Settings used to create the network
+	GeneratorSettings settings_;
+	// Random number generator, shared by structure, tables and samples
+	std::mt19937 generator_;
+	// The generated structure
+	Network network_;
+	// Number of values per node
+	std::vector<unsigned int> cardinalities_;
+	// Conditional probability table per node
+	std::vector<Table<float>> probabilities_;
+};
+
+#endif
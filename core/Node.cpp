@@ -1,5 +1,8 @@
 #include "Node.h"
 
+#include <algorithm>
+#include <stdexcept>
+
 Node::Node(unsigned int index, unsigned int id, const std::string& name)
 	: index_(index),
 	  id_(id),
@@ -20,17 +23,85 @@ void Node::setProbability(float value, unsigned int nv, unsigned int pv)
 	ProbabilityMatrix_.setData(value, nv, pv);
 }
 
+// Finds the position of name in names, -1 if it is not contained
+static int findName(const std::vector<std::string>& names,
+                    const std::string& name)
+{
+	auto it = std::find(names.begin(), names.end(), name);
+	if(it == names.end()) {
+		return -1;
+	}
+	return it - names.begin();
+}
+
+// Matches the value names of the parents from parent on against pv starting
+// at begin and adds them to row. Value names may contain commas themselves,
+// hence the longest name that is followed by a comma, or by the end for the
+// last parent, is tried first and shorter ones if the rest does not match.
+static int matchParentNames(
+    const std::vector<std::vector<std::string>>& nameLists,
+    const std::string& pv, unsigned int parent, size_t begin, int row)
+{
+	if(parent == nameLists.size()) {
+		return row;
+	}
+	const bool last = parent + 1 == nameLists.size();
+	const auto& names = nameLists[parent];
+	std::vector<unsigned int> candidates;
+	for(unsigned int i = 0; i < names.size(); i++) {
+		const size_t end = begin + names[i].size();
+		if(end <= pv.size() && pv.compare(begin, names[i].size(), names[i]) == 0 &&
+		   (last ? end == pv.size() : end < pv.size() && pv[end] == ',')) {
+			candidates.push_back(i);
+		}
+	}
+	std::sort(candidates.begin(), candidates.end(),
+	          [&names](unsigned int a, unsigned int b) {
+		          return names[a].size() > names[b].size();
+	          });
+	for(auto i : candidates) {
+		const int result =
+		    matchParentNames(nameLists, pv, parent + 1,
+		                     begin + names[i].size() + 1, row * names.size() + i);
+		if(result != -1) {
+			return result;
+		}
+	}
+	return -1;
+}
+
+// Finds the row of the CPT belonging to the comma separated parent value
+// names pv, -1 if it does not exist. The last parent changes fastest.
+static int findParentRow(
+    const std::vector<std::vector<std::string>>& nameLists,
+    const std::string& pv)
+{
+	if(nameLists.empty()) {
+		return pv == "1" ? 0 : -1;
+	}
+	return matchParentNames(nameLists, pv, 0, 0, 0);
+}
+
 float Node::getProbability(const std::string& nv, const std::string& pv)
     const
 {
-	return ProbabilityMatrix_.getValueByNames(nv, pv);
+	int col = findName(valueNamesProb_, nv);
+	int row = findParentRow(parentValueNameLists_, pv);
+	if(row == -1 || col == -1) {
+		throw std::invalid_argument("Specified elements not found");
+	}
+	return ProbabilityMatrix_(col, row);
 }
 
 void Node::setProbability(float value, const std::string& nv,
                           const std::string& pv)
 {
-	ProbabilityMatrix_.setData(value, ProbabilityMatrix_.findCol(nv),
-	                           ProbabilityMatrix_.findRow(pv));
+	int col = findName(valueNamesProb_, nv);
+	int row = findParentRow(parentValueNameLists_, pv);
+	if(row == -1 || col == -1) {
+		throw std::invalid_argument("Specified elements not found");
+	}
+	ProbabilityMatrix_.setData(value, col, row);
 }
 
 unsigned int Node::getObservations(unsigned int nv, unsigned int pv) const
@@ -46,23 +117,27 @@ void Node::setObservations(int value, unsigned int nv, unsigned int pv)
 unsigned int Node::getObservations(const std::string& nv,
                                          const std::string& pv) const
 {
-	return ObservationMatrix_.getValueByNames(nv, pv);
+	int col = findName(valueNames_, nv);
+	int row = findParentRow(parentValueNameLists_, pv);
+	if(row == -1 || col == -1) {
+		throw std::invalid_argument("Specified elements not found");
+	}
+	return ObservationMatrix_(col, row);
 }
 
 void Node::setObservations(int value, const std::string& nv,
                            const std::string& pv)
 {
-	ObservationMatrix_.setData(value, ObservationMatrix_.findCol(nv),
-	                           ObservationMatrix_.findRow(pv));
+	int col = findName(valueNames_, nv);
+	int row = findParentRow(parentValueNameLists_, pv);
+	if(row == -1 || col == -1) {
+		throw std::invalid_argument("Specified elements not found");
+	}
+	ObservationMatrix_.setData(value, col, row);
 }
-void Node::setProbability(const Matrix<float>& m) { ProbabilityMatrix_ = m; }
+void Node::setProbability(const Table<float>& m) { ProbabilityMatrix_ = m; }
 
-void Node::setObservations(const Matrix<int>& m) { ObservationMatrix_ = m; }
-
-void Node::setObservationBackup(const Matrix<int>& m)
-{
-	ObservationMatrix_ = m;
-}
+void Node::setObservations(const Table<int>& m) { ObservationMatrix_ = m; }
 
 const std::string& Node::getName() const { return name_; }
 
@@ -72,31 +147,61 @@ const unsigned int& Node::getID() const { return id_; }
 
 bool Node::hasValue(const std::string& v) const
 {
-	return ObservationMatrix_.findCol(v) > -1;
+	return findName(valueNames_, v) > -1;
+}
+
+bool Node::hasNA() const
+{
+	return uniqueValues_.size() != uniqueValuesExcludingNA_.size();
 }
 
-Matrix<float>& Node::getProbabilityMatrix() { return ProbabilityMatrix_; }
+Table<float>& Node::getProbabilityMatrix() { return ProbabilityMatrix_; }
 
-const Matrix<float>& Node::getProbabilityMatrix() const
+const Table<float>& Node::getProbabilityMatrix() const
 {
 	return ProbabilityMatrix_;
 }
 
-Matrix<int>& Node::getObservationMatrix() { return ObservationMatrix_; }
+Table<int>& Node::getObservationMatrix() { return ObservationMatrix_; }
+
+const Table<int>& Node::getObservationMatrix() const
+{
+	return ObservationMatrix_;
+}
+
+// Writes a table of the node, the row names are generated on demand
+template <typename T>
+static void printTable(std::ostream& os, const Node& n, const Table<T>& table,
+                       const std::vector<std::string>& colNames)
+{
+	os << "\t";
+	for(const auto& name : colNames) {
+		os << name << "\t";
+	}
+	os << "\n";
+	for(unsigned int row = 0; row < table.getRowCount(); row++) {
+		os << n.getParentValueName(row) << "\t";
+		for(unsigned int col = 0; col < table.getColCount(); col++) {
+			os << table(col, row) << "\t";
+		}
+		if(row + 1 < table.getRowCount()) {
+			os << "\n";
+		}
+	}
+}
 
 std::ostream& operator<<(std::ostream& os, const Node& n)
 {
 	os << "Node name: " << n.name_ << "\nNode id: " << n.id_
-	   << "\nObservation matrix:\n" << n.ObservationMatrix_
-	   << "\n\nProbability matrix:\n" << n.ProbabilityMatrix_ << std::endl;
+	   << "\nObservation matrix:\n";
+	printTable(os, n, n.ObservationMatrix_, n.valueNames_);
+	os << "\n\nProbability matrix:\n";
+	printTable(os, n, n.ProbabilityMatrix_, n.valueNamesProb_);
+	os << std::endl;
 
 	return os;
 }
 
-void Node::createBackup() { ObservationBackup_ = ObservationMatrix_; }
-
-void Node::loadBackup() { ObservationMatrix_ = ObservationBackup_; }
-
 const std::vector<unsigned int>& Node::getParents() const { return Parents_; }
 
 size_t Node::getNumberOfParents() const {
@@ -110,7 +215,13 @@ void Node::setParents(const std::vector<unsigned int>& parents)
 	factor_.resize(parents.size());
 }
 
-void Node::cutParents() { Parents_.clear(); parentValues_.clear(); factor_.clear();}
+void Node::cutParents()
+{
+	Parents_.clear();
+	parentValues_.clear();
+	parentValuesStride_ = 0;
+	factor_.clear();
+}
 
 void Node::setUniqueValues(const std::vector<int>& uniqueValues)
 {
@@ -145,7 +256,11 @@ size_t Node::getNumberOfUniqueValuesExcludingNA() const
 
 size_t Node::getNumberOfParentValues() const
 {
-	return parentValueNames_.size();
+	size_t result = 1;
+	for(const auto& names : parentValueNameLists_) {
+		result *= names.size();
+	}
+	return result;
 }
 
 void Node::setObservationRow(int row) { observationRow_ = row; }
@@ -189,19 +304,48 @@ const std::vector<std::string>& Node::getValueNamesProb() const
 	return valueNamesProb_;
 }
 
-void Node::setParentValueNames(const std::vector<std::string>& valueNames)
+void Node::setParentValueNameLists(
+    std::vector<std::vector<std::string>> names)
+{
+	parentValueNameLists_ = std::move(names);
+}
+
+const std::vector<std::vector<std::string>>& Node::getParentValueNameLists()
+    const
 {
-	parentValueNames_ = valueNames;
+	return parentValueNameLists_;
 }
 
-void Node::addParentValueName(const std::string& names)
+std::string Node::getParentValueName(unsigned int row) const
 {
-	parentValueNames_.push_back(names);
+	if(parentValueNameLists_.empty()) {
+		return "1";
+	}
+	std::vector<unsigned int> digits(parentValueNameLists_.size());
+	for(size_t i = parentValueNameLists_.size(); i-- > 0;) {
+		const auto radix = parentValueNameLists_[i].size();
+		digits[i] = row % radix;
+		row /= radix;
+	}
+	std::string result;
+	for(unsigned int i = 0; i < digits.size(); i++) {
+		if(i != 0) {
+			result += ",";
+		}
+		result += parentValueNameLists_[i][digits[i]];
+	}
+	return result;
 }
 
-const std::vector<std::string>& Node::getParentValueNames() const
+std::vector<std::string> Node::getParentValueNames() const
 {
-	return parentValueNames_;
+	std::vector<std::string> result;
+	const size_t rows = getNumberOfParentValues();
+	result.reserve(rows);
+	for(unsigned int row = 0; row < rows; row++) {
+		result.push_back(getParentValueName(row));
+	}
+	return result;
 }
 
 void Node::setUnvisited() { visited_ = false; }
@@ -215,8 +359,8 @@ void Node::createBackupDoIntervention()
 	ProbabilityMatrixBackup_ = ProbabilityMatrix_;
 	ParentsBackup_ = Parents_;
 	factorBackup_ = factor_;
-	revFactorBackup_ = revFactor_;
 	parentValuesBackup_ = parentValues_;
+	parentValuesStrideBackup_ = parentValuesStride_;
 }
 
 void Node::loadBackupDoIntervention()
@@ -224,23 +368,18 @@ void Node::loadBackupDoIntervention()
 	ProbabilityMatrix_ = ProbabilityMatrixBackup_;
 	Parents_ = ParentsBackup_;
 	factor_ = factorBackup_;
-	revFactor_ = revFactorBackup_;
 	parentValues_ = parentValuesBackup_;
+	parentValuesStride_ = parentValuesStrideBackup_;
 	parentValuesBackup_.clear();
 	ParentsBackup_.clear();
 	factorBackup_.clear();
-	ProbabilityMatrixBackup_ = Matrix<float>(0, 0, 0.0);
+	ProbabilityMatrixBackup_ = Table<float>(0, 0, 0.0f);
 }
 
 void Node::setProbabilityTo1(const std::string& value)
 {
-	for(unsigned int col = 0; col < ProbabilityMatrix_.getColCount(); col++) {
-		for(unsigned int row = 0; row < ProbabilityMatrix_.getRowCount();
-		    row++) {
-			ProbabilityMatrix_.setData(0.0f, col, row);
-		}
-	}
-	unsigned int col = ProbabilityMatrix_.findCol(value);
+	ProbabilityMatrix_.fill(0.0f);
+	unsigned int col = getIndex(value);
 	for(unsigned int row = 0; row < ProbabilityMatrix_.getRowCount(); row++) {
 		ProbabilityMatrix_.setData(1.0f, col, row);
 
@@ -249,12 +388,7 @@ void Node::setProbabilityTo1(const std::string& value)
 
 void Node::setProbabilityTo1(int value)
 {
-	for(unsigned int col = 0; col < ProbabilityMatrix_.getColCount(); col++) {
-		for(unsigned int row = 0; row < ProbabilityMatrix_.getRowCount();
-		    row++) {
-			ProbabilityMatrix_.setData(0.0f, col, row);
-		}
-	}
+	ProbabilityMatrix_.fill(0.0f);
 	for(unsigned int row = 0; row < ProbabilityMatrix_.getRowCount(); row++) {
 		ProbabilityMatrix_.setData(1.0f, value, row);
 	}
@@ -262,7 +396,7 @@ void Node::setProbabilityTo1(int value)
 
 int Node::getIndex(const std::string& value) const
 {
-	return ProbabilityMatrix_.findCol(value);
+	return findName(valueNamesProb_, value);
 }
 
 void Node::clearNameVectors()
@@ -270,8 +404,9 @@ void Node::clearNameVectors()
 	uniqueValues_.clear();
 	valueNames_.clear();
 	valueNamesProb_.clear();
-	parentValueNames_.clear();
+	parentValueNameLists_.clear();
 	parentValues_.clear();
+	parentValuesStride_ = 0;
 	uniqueValuesExcludingNA_.clear();
 }
 
@@ -288,17 +423,23 @@ float Node::getCalculatedValue(unsigned int index, unsigned int row) const{
 }
 
 void Node::clearDynProgMatrix(){
-	DynProgMatrix_ = Matrix<float>(valueNamesProb_,parentValueNames_,-1.0f);
+	DynProgMatrix_.assign(ProbabilityMatrix_.getColCount(),
+	                      ProbabilityMatrix_.getRowCount(), -1.0f);
 }
 
-void Node::setParentValues(std::vector<std::vector<int>>& pValues){
-	parentValues_ = pValues;
+void Node::setParentValues(std::vector<ParentValue> pValues){
+	parentValues_ = std::move(pValues);
+	parentValuesStride_ = Parents_.size();
 }
 
-const std::vector<std::vector<int>>& Node::getParentValues() const{
+const std::vector<Node::ParentValue>& Node::getParentValues() const{
 	return parentValues_;
 }
 
+unsigned int Node::getParentValue(unsigned int row, unsigned int position) const{
+	return parentValues_[row * parentValuesStride_ + position];
+}
+
 void Node::setName(std::string name){
 	name_ = name;
 }
@@ -308,11 +449,10 @@ void Node::setID(unsigned int id){
 }
 
 void Node::reset(){
-	ProbabilityMatrix_ =  Matrix<float>(0, 0, 0.0f);
-	ProbabilityMatrixBackup_ = Matrix<float>(0, 0, 0.0f);
-    ObservationMatrix_ = Matrix<int>(0, 0, 0);
-    ObservationBackup_ = Matrix<int>(0, 0, 0);
-	DynProgMatrix_ =Matrix<float>(0, 0, -1.0f);
+	ProbabilityMatrix_ = Table<float>(0, 0, 0.0f);
+	ProbabilityMatrixBackup_ = Table<float>(0, 0, 0.0f);
+	ObservationMatrix_ = Table<int>(0, 0, 0);
+	DynProgMatrix_ = Table<float>(0, 0, -1.0f);
 }
 
 void Node::setFactor(unsigned int factor, unsigned int id){
@@ -322,19 +462,3 @@ void Node::setFactor(unsigned int factor, unsigned int id){
 unsigned int Node::getFactor(unsigned int id) const {
 	return factor_[id];
 }
-
-void Node::setRevFactor(unsigned int factor, unsigned int row, unsigned int id){
-	revFactor_[row][id]=factor;
-}
-
-unsigned int Node::getRevFactor(unsigned int row, unsigned int id) const {
-	return revFactor_[row][id];
-}
-
-void Node::initialiseRevFactor(){
-	std::vector<unsigned int> empty;
-	empty.clear();
-	empty.resize(getParents().size(),0);	
-	revFactor_.clear();
-	revFactor_.resize(ProbabilityMatrix_.getRowCount(),empty);
-}
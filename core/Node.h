@@ -1,9 +1,16 @@
 #ifndef NODE_H
 #define NODE_H
-#include "Matrix.h"
+#include "Table.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
 
 class Node {
 	public:
+	//Integer type used to store the values of the parents for every row of the CPT
+	using ParentValue = std::uint16_t;
+
 	/**Node
 	 *
 	 * @param index, the index for this node in the nodeList_
@@ -103,11 +110,11 @@ class Node {
 	
 	/**setProbability
 	 *
-	 * @param m, Matrix of type float containing probabilties
+	 * @param m, Table of type float containing probabilties
 	 *
  	 * Sets the probabilty matrix in the node object
 	 */
-	void setProbability(const Matrix<float>& m);	
+	void setProbability(const Table<float>& m);	
 	
 	/**setProbabilityTo1
 	 *
@@ -142,19 +149,11 @@ class Node {
 	
 	/**setObservations
 	 *
-	 * @param m, Matrix of typ int containing observationcounts
+	 * @param m, Table of typ int containing observationcounts
 	 *
 	 * Sets the entire observation matrix
 	 */
-	void setObservations(const Matrix<int>& m);
-	
-	/**setObservationBackup
-	 *
-	 * @param
-	 *
- 	 * Generates a backup of the observation matrix
-	 */
-	void setObservationBackup(const Matrix<int>& m);
+	void setObservations(const Table<int>& m);
 	
 	/**getName
 	 *
@@ -210,6 +209,13 @@ class Node {
  	 * Checks whether v is a value of this node
 	 */
 	bool hasValue(const std::string& v) const;
+
+	/**hasNA
+	 *
+	 * @return bool, true if the observations of this node contain NAs. In this
+	 * case, the first column of the observation matrix counts the NAs.
+	 */
+	bool hasNA() const;
 	
 	/**getParents
 	 *
@@ -278,7 +284,8 @@ class Node {
 
 	/**getNumberOfParentValues
 	 *
-	 * @return The number of different value combinatons with respect to the parents
+	 * @return The number of different value combinatons with respect to the parents,
+	 * i.e. the number of rows of the CPT
 	 *
 	 */
 	size_t getNumberOfParentValues() const;
@@ -375,56 +382,67 @@ class Node {
 	 */
 	const std::vector<std::string>& getValueNamesProb() const;
 	
-	/**setParentValueNames
+	/**setParentValueNameLists
 	 *
-	 * @param valueNames, vector containing the parent value names
+	 * @param names, for every parent the names of its values, ordered as
+	 * the unique values of the parent excluding NAs
  	 *
-	 * Sets the parentValueNames
+	 * Sets the names used to describe the rows of the CPT
 	 */
-	void setParentValueNames(const std::vector<std::string>& valueNames); 
+	void setParentValueNameLists(std::vector<std::vector<std::string>> names);
 
-	/**addParentValueName
+	/**getParentValueNameLists
 	 *
-	 * @param name
+	 * @return A reference to the value names of every parent
+ 	 *
+	 */
+	const std::vector<std::vector<std::string>>& getParentValueNameLists() const;
+
+	/**getParentValueName
+	 *
+	 * @param row, row of the CPT
 	 *
- 	 * Adds a single name to the parentValueName vector
+	 * @return The comma separated names of the parent values belonging to the
+	 * given row, "1" for a node without parents
+ 	 *
+	 * The name is generated on demand and is intended for display only
 	 */
-	void addParentValueName(const std::string& name);
+	std::string getParentValueName(unsigned int row) const;
 
 	/**getParentValueNames
 	 *
-	 * @return A reference to the parentValueNames vector
+	 * @return A vector containing the names of all rows of the CPT, see getParentValueName
  	 *
 	 */
-	const std::vector<std::string>& getParentValueNames() const;
+	std::vector<std::string> getParentValueNames() const;
 
 	/**getProbabilitiyMatrix
 	 *
 	 * @return A reference to the probability matrix
  	 *
 	 */
-	Matrix<float>& getProbabilityMatrix();
+	Table<float>& getProbabilityMatrix();
 	
 	/**getProbabilitiyMatrix
 	 *
 	 * @return A const reference to the probability matrix
 	 *
 	 */
-	const Matrix<float>& getProbabilityMatrix() const;
+	const Table<float>& getProbabilityMatrix() const;
 
 	/**getObservationMatrix
 	 *
 	 * @return A reference to the observation matrix
 	 *
 	 */
-	Matrix<int>& getObservationMatrix();
+	Table<int>& getObservationMatrix();
 
 	/**getObservationMatrix
 	 *
 	 * @return A const reference to the observation matrix
 	 *
 	 */
-	const Matrix<int>& getObservationMatrix() const;
+	const Table<int>& getObservationMatrix() const;
 
 	/**isCalculated
 	 *
@@ -464,18 +482,6 @@ class Node {
 	 */
 	void clearDynProgMatrix();
 
-	/**createBackup
-	 *
- 	 * Creates a backup of the node
-	 */
-	void createBackup();
-
-	/**loadBackup
-	 *
- 	 * Loads a backup of the node
-	 */
-	void loadBackup();
-
 	/**setUnvisited
 	 *
  	 * Marks the node as unvisited
@@ -502,36 +508,29 @@ class Node {
 
 	/**setParentValues
 	 *
- 	 * @param pValues, a vector containing vectors representing the integer representation of the 
-	 * parents of this node specifcally for every possible combination
+ 	 * @param pValues, a flat table containing the integer representation of the
+	 * values of the parents of this node for every row of the CPT. The values of
+	 * row r are stored at positions [r * getNumberOfParents(), (r + 1) * getNumberOfParents())
 	 *
 	 * Sets the parentValues
 	 */
-	void setParentValues(std::vector<std::vector<int>>& pValues);
+	void setParentValues(std::vector<ParentValue> pValues);
 	
 	/**getParentValues
 	 *
-	 * @return A vector containing vectors of integers representing the values of the parents of this node
-	 * for every combination
+	 * @return The flat table of parent values of this node, see setParentValues
 	 *
 	 */
-	const std::vector<std::vector<int>>& getParentValues() const;
+	const std::vector<ParentValue>& getParentValues() const;
 
-	/**getFactor
-	 *
-	 * @param id, the identifier of the node for which we want to compute the factor
+	/**getParentValue
 	 *
-	 * @return the factor of the node
-	 */
-	unsigned int getFactor(unsigned int id) const;
-	
-	/**setFactor
+	 * @param row, row of the CPT
+	 * @param position, position of the parent in question in the parent list
 	 *
-	 * @param factor, factor to be stored
-	 * @param id, identifier of the factor
+	 * @return The value of the given parent in the given row of the CPT
 	 */
-	void setFactor(unsigned int factor, unsigned int id);	
-
+	unsigned int getParentValue(unsigned int row, unsigned int position) const;
 
 	/**getFactor
 	 *
@@ -539,17 +538,14 @@ class Node {
 	 *
 	 * @return the factor of the node
 	 */
-	unsigned int getRevFactor(unsigned int row, unsigned int id) const;
+	unsigned int getFactor(unsigned int id) const;
 	
 	/**setFactor
 	 *
 	 * @param factor, factor to be stored
 	 * @param id, identifier of the factor
 	 */
-	void setRevFactor(unsigned int factor, unsigned int row, unsigned int id);	
-
-	void initialiseRevFactor();
-	
+	void setFactor(unsigned int factor, unsigned int id);	
 
 	/**reset
 	 *
@@ -578,25 +574,29 @@ class Node {
 	std::string name_;
 	//Matrices storing the CPTs for a node, including a backup to restore
 	//the original state when interventions are reversed
-	Matrix<float> ProbabilityMatrix_;
-	Matrix<float> ProbabilityMatrixBackup_;
+	Table<float> ProbabilityMatrix_;
+	Table<float> ProbabilityMatrixBackup_;
 	//Matrices storing the observation counts
-	Matrix<int> ObservationMatrix_;
-	Matrix<int> ObservationBackup_;
+	Table<int> ObservationMatrix_;
 	//Matrix to store results during dynamic programming to calculat total probabilities
-	Matrix<float> DynProgMatrix_;
+	Table<float> DynProgMatrix_;
 	//Vector containing the integer representation of all unique values of this node
 	std::vector<int> uniqueValues_;
 	//Vector containing the names for all possible values (including NAs) of this node
 	std::vector<std::string> valueNames_;
 	//Vector containing the names for the probability matrix of this node
 	std::vector<std::string> valueNamesProb_;
-	//Vector containing the original names of the parent values
-	std::vector<std::string> parentValueNames_;
-	//All possible parent values, including a backup to restore the original
+	//Vector containing the original value names of every parent. The names of
+	//the parent value combinations are generated from these lists on demand
+	std::vector<std::vector<std::string>> parentValueNameLists_;
+	//Values of the parents for every row of the CPT, stored row by row. This
+	//table is built during training, including a backup to restore the original
 	//state when interventions are reversed
-	std::vector<std::vector<int>> parentValues_;
-	std::vector<std::vector<int>> parentValuesBackup_;
+	std::vector<ParentValue> parentValues_;
+	std::vector<ParentValue> parentValuesBackup_;
+	//The number of parents per row of parentValues_
+	unsigned int parentValuesStride_ = 0;
+	unsigned int parentValuesStrideBackup_ = 0;
 	//A vector of all unqiue Values excluding NAs
 	std::vector<int> uniqueValuesExcludingNA_;
 	//The row of the Observations Matrix belonging to this node
@@ -609,9 +609,5 @@ class Node {
 	std::vector<unsigned int> factor_;
 	//A vector to store a backup of the computed factors
 	std::vector<unsigned int> factorBackup_;
-	//Vector containing the reversed factors
-	std::vector<std::vector<unsigned int>> revFactor_;
-	//Vector containing a backup of the reversed factors
-	std::vector<std::vector<unsigned int>> revFactorBackup_;
 };
 #endif
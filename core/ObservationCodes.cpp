@@ -0,0 +1,224 @@
+#include "ObservationCodes.h"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+// Matrices may have fewer row names than rows
+std::vector<std::string> getAllRowNames(const Matrix<int>& observations)
+{
+	std::vector<std::string> rowNames = observations.getRowNames();
+	rowNames.resize(observations.getRowCount());
+	return rowNames;
+}
+
+int getMaxValue(const Matrix<int>& observations)
+{
+	int maxValue = -1;
+	for(unsigned int row = 0; row < observations.getRowCount(); row++) {
+		for(unsigned int col = 0; col < observations.getColCount(); col++) {
+			const int value = observations(col, row);
+			if(value < -1) {
+				throw std::invalid_argument("Invalid discretised value " +
+				                            std::to_string(value));
+			}
+			maxValue = std::max(maxValue, value);
+		}
+	}
+	return maxValue;
+}
+}
+
+ObservationCodes::ObservationCodes() : colCount_(0), rowCount_(0), width_(1) {}
+
+ObservationCodes::ObservationCodes(unsigned int colCount,
+                                   const std::vector<std::string>& rowNames,
+                                   int maxValue)
+    : colCount_(colCount),
+      rowCount_(rowNames.size()),
+      width_(getWidthFor(maxValue)),
+      rowNames_(rowNames)
+{
+	const size_t size = static_cast<size_t>(colCount_) * rowCount_;
+	switch(width_) {
+		case 1:
+			codes8_.assign(size, NA);
+			break;
+		case 2:
+			codes16_.assign(size, NA);
+			break;
+		default:
+			codes32_.assign(size, NA);
+			break;
+	}
+	for(unsigned int row = 0; row < rowCount_; row++) {
+		rowNamesToIndex_[rowNames_[row]] = row;
+	}
+}
+
+ObservationCodes::ObservationCodes(const Matrix<int>& observations)
+    : ObservationCodes(observations.getColCount(), getAllRowNames(observations),
+                       getMaxValue(observations))
+{
+	colNames_ = observations.getColNames();
+	visit([&](auto code) {
+		using Code = decltype(code);
+		for(unsigned int row = 0; row < rowCount_; row++) {
+			Code* codes = getRow<Code>(row);
+			for(unsigned int col = 0; col < colCount_; col++) {
+				codes[col] = static_cast<Code>(observations(col, row) + 1);
+			}
+		}
+	});
+}
+
+unsigned int ObservationCodes::getWidthFor(int maxValue)
+{
+	// The code of a value is the value plus one
+	if(maxValue < std::numeric_limits<std::uint8_t>::max()) {
+		return 1;
+	}
+	if(maxValue < std::numeric_limits<std::uint16_t>::max()) {
+		return 2;
+	}
+	return 4;
+}
+
+unsigned int ObservationCodes::getColCount() const { return colCount_; }
+
+unsigned int ObservationCodes::getRowCount() const { return rowCount_; }
+
+unsigned int ObservationCodes::getWidth() const { return width_; }
+
+const std::vector<std::string>& ObservationCodes::getRowNames() const
+{
+	return rowNames_;
+}
+
+const std::vector<std::string>& ObservationCodes::getColNames() const
+{
+	return colNames_;
+}
+
+void ObservationCodes::setColNames(const std::vector<std::string>& colNames)
+{
+	colNames_ = colNames;
+}
+
+int ObservationCodes::findRow(const std::string& name) const
+{
+	const auto it = rowNamesToIndex_.find(name);
+	if(it == rowNamesToIndex_.end()) {
+		return -1;
+	}
+	return it->second;
+}
+
+int ObservationCodes::operator()(unsigned int col, unsigned int row) const
+{
+	return visit([&](auto code) {
+		return static_cast<int>(getRow<decltype(code)>(row)[col]) - 1;
+	});
+}
+
+void ObservationCodes::setData(int value, unsigned int col, unsigned int row)
+{
+	if(col >= colCount_ || row >= rowCount_) {
+		throw std::invalid_argument("In setData, Invalid position");
+	}
+	if(value < -1 || getWidthFor(value) > width_) {
+		throw std::invalid_argument("Value " + std::to_string(value) +
+		                            " does not fit into the codes");
+	}
+	visit([&](auto code) {
+		using Code = decltype(code);
+		getRow<Code>(row)[col] = static_cast<Code>(value + 1);
+	});
+}
+
+void ObservationCodes::setRow(unsigned int row, const std::vector<int>& values)
+{
+	if(row >= rowCount_ || values.size() != colCount_) {
+		throw std::invalid_argument("In setRow, Invalid position");
+	}
+	for(auto value : values) {
+		if(value < -1 || getWidthFor(value) > width_) {
+			throw std::invalid_argument("Value " + std::to_string(value) +
+			                            " does not fit into the codes");
+		}
+	}
+	visit([&](auto code) {
+		using Code = decltype(code);
+		Code* codes = getRow<Code>(row);
+		for(unsigned int col = 0; col < colCount_; col++) {
+			codes[col] = static_cast<Code>(values[col] + 1);
+		}
+	});
+}
+
+std::vector<int> ObservationCodes::getUniqueRowValues(unsigned int row) const
+{
+	return visit([&](auto code) {
+		using Code = decltype(code);
+		const Code* codes = getRow<Code>(row);
+		// Codes are dense in practice, hence a flag per code is cheaper
+		// than sorting the row
+		std::vector<bool> seen;
+		for(unsigned int col = 0; col < colCount_; col++) {
+			if(codes[col] >= seen.size()) {
+				seen.resize(static_cast<size_t>(codes[col]) + 1);
+			}
+			seen[codes[col]] = true;
+		}
+		std::vector<int> values;
+		for(size_t c = 0; c < seen.size(); c++) {
+			if(seen[c]) {
+				values.push_back(static_cast<int>(c) - 1);
+			}
+		}
+		return values;
+	});
+}
+
+std::vector<int> ObservationCodes::getUniqueRowValues(unsigned int row,
+                                                      int exclude) const
+{
+	std::vector<int> values = getUniqueRowValues(row);
+	values.erase(std::remove(values.begin(), values.end(), exclude),
+	             values.end());
+	return values;
+}
+
+Matrix<int> ObservationCodes::toMatrix() const
+{
+	Matrix<int> observations(colCount_, rowCount_, -1, colNames_, rowNames_);
+	for(unsigned int row = 0; row < rowCount_; row++) {
+		for(unsigned int col = 0; col < colCount_; col++) {
+			observations(col, row) = (*this)(col, row);
+		}
+	}
+	return observations;
+}
+
+std::ostream& operator<<(std::ostream& os, const ObservationCodes& observations)
+{
+	os << "\t";
+	for(const auto& name : observations.getColNames()) {
+		os << name << "\t";
+	}
+	os << "\n";
+	const unsigned int rowCount = observations.getRowCount();
+	for(unsigned int row = 0; row < rowCount; row++) {
+		os << observations.getRowNames()[row] << "\t";
+		for(unsigned int col = 0; col < observations.getColCount(); col++) {
+			os << observations(col, row) << "\t";
+		}
+		if(row < rowCount - 1) {
+			os << "\n";
+		}
+	}
+	return os;
+}
@@ -0,0 +1,251 @@
+#ifndef OBSERVATIONCODES_H
+#define OBSERVATIONCODES_H
+
+#include "Matrix.h"
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Discretised observations stored as narrow unsigned codes. The code of a
+ * value is the value plus one, such that code 0 marks a missing value. The
+ * width of the codes is chosen from the largest value: one byte for up to 255
+ * values, two bytes for up to 65535 values and four bytes otherwise. As in
+ * the Matrix class, the samples are the columns and the codes of a row are
+ * stored contiguously.
+ */
+class ObservationCodes
+{
+	public:
+	// Code of a missing value
+	static constexpr unsigned int NA = 0;
+
+	/**ObservationCodes
+	 *
+	 * Creates empty observations.
+	 */
+	ObservationCodes();
+
+	/**ObservationCodes
+	 *
+	 * @param observations, discretised observations, -1 denotes a missing
+	 * value
+	 *
+	 * @throw invalid_argument if a value is smaller than -1
+	 */
+	explicit ObservationCodes(const Matrix<int>& observations);
+
+	/**ObservationCodes
+	 *
+	 * @param colCount, number of samples
+	 * @param rowNames, names of the rows
+	 * @param maxValue, largest value that will be stored, determines the
+	 * width of the codes
+	 *
+	 * Creates observations in which all values are missing.
+	 */
+	ObservationCodes(unsigned int colCount,
+	                 const std::vector<std::string>& rowNames, int maxValue);
+
+	/**getWidthFor
+	 *
+	 * @param maxValue, largest value that has to be stored
+	 *
+	 * @return the width of the codes in bytes
+	 */
+	static unsigned int getWidthFor(int maxValue);
+
+	/**getColCount
+	 *
+	 * @return the number of samples
+	 */
+	unsigned int getColCount() const;
+
+	/**getRowCount
+	 *
+	 * @return the number of rows
+	 */
+	unsigned int getRowCount() const;
+
+	/**getWidth
+	 *
+	 * @return the width of the codes in bytes
+	 */
+	unsigned int getWidth() const;
+
+	/**getRowNames
+	 *
+	 * @return the names of the rows
+	 */
+	const std::vector<std::string>& getRowNames() const;
+
+	/**getColNames
+	 *
+	 * @return the names of the samples
+	 */
+	const std::vector<std::string>& getColNames() const;
+
+	/**setColNames
+	 *
+	 * @param colNames, the names of the samples
+	 */
+	void setColNames(const std::vector<std::string>& colNames);
+
+	/**findRow
+	 *
+	 * @param name, name of the row
+	 *
+	 * @return the index of the row or -1 if it does not exist
+	 */
+	int findRow(const std::string& name) const;
+
+	/**operator()
+	 *
+	 * @param col, index of the sample
+	 * @param row, index of the row
+	 *
+	 * @return the value at the position, -1 for a missing value. The position
+	 * is not checked.
+	 */
+	int operator()(unsigned int col, unsigned int row) const;
+
+	/**setData
+	 *
+	 * @param value, value to be stored, -1 for a missing value
+	 * @param col, index of the sample
+	 * @param row, index of the row
+	 *
+	 * @throw invalid_argument if the position is not inside the observations
+	 * or the value does not fit into the width of the codes
+	 */
+	void setData(int value, unsigned int col, unsigned int row);
+
+	/**setRow
+	 *
+	 * @param row, index of the row
+	 * @param values, one value per sample, -1 for a missing value
+	 *
+	 * @throw invalid_argument if the row does not exist, the number of values
+	 * differs from the number of samples or a value does not fit into the
+	 * codes
+	 */
+	void setRow(unsigned int row, const std::vector<int>& values);
+
+	/**getUniqueRowValues
+	 *
+	 * @param row, index of the row
+	 *
+	 * @return the sorted values of the row, including -1 if a value is missing
+	 */
+	std::vector<int> getUniqueRowValues(unsigned int row) const;
+
+	/**getUniqueRowValues
+	 *
+	 * @param row, index of the row
+	 * @param exclude, a value to exclude
+	 *
+	 * @return the sorted values of the row without exclude
+	 */
+	std::vector<int> getUniqueRowValues(unsigned int row, int exclude) const;
+
+	/**toMatrix
+	 *
+	 * @return the observations as a matrix of values, -1 denotes a missing
+	 * value
+	 */
+	Matrix<int> toMatrix() const;
+
+	/**getRow
+	 *
+	 * @param row, index of the row
+	 *
+	 * @return a pointer to the codes of the row. Code has to be the type of
+	 * the width of the codes.
+	 */
+	template <typename Code> const Code* getRow(unsigned int row) const;
+	template <typename Code> Code* getRow(unsigned int row);
+
+	/**visit
+	 *
+	 * @param f, a function object called with a value of the code type, e.g.
+	 * a generic lambda, such that loops over the codes are compiled for the
+	 * actual width
+	 *
+	 * @return the result of f
+	 */
+	template <typename Function> decltype(auto) visit(Function&& f) const;
+
+	private:
+	template <typename Code> const std::vector<Code>& getCodes_() const;
+
+	unsigned int colCount_;
+	unsigned int rowCount_;
+	unsigned int width_;
+	// Only the vector of the chosen width is used
+	std::vector<std::uint8_t> codes8_;
+	std::vector<std::uint16_t> codes16_;
+	std::vector<std::uint32_t> codes32_;
+	std::vector<std::string> rowNames_;
+	std::vector<std::string> colNames_;
+	std::unordered_map<std::string, unsigned int> rowNamesToIndex_;
+};
+
+/**operator<<
+ *
+ * @param os, reference to an ostream object
+ * @param observations, the observations to be printed like a Matrix of values
+ *
+ * @return an ostream reference
+ */
+std::ostream& operator<<(std::ostream& os, const ObservationCodes& observations);
+
+template <>
+inline const std::vector<std::uint8_t>&
+ObservationCodes::getCodes_<std::uint8_t>() const
+{
+	return codes8_;
+}
+
+template <>
+inline const std::vector<std::uint16_t>&
+ObservationCodes::getCodes_<std::uint16_t>() const
+{
+	return codes16_;
+}
+
+template <>
+inline const std::vector<std::uint32_t>&
+ObservationCodes::getCodes_<std::uint32_t>() const
+{
+	return codes32_;
+}
+
+template <typename Code>
+const Code* ObservationCodes::getRow(unsigned int row) const
+{
+	return getCodes_<Code>().data() + static_cast<size_t>(row) * colCount_;
+}
+
+template <typename Code> Code* ObservationCodes::getRow(unsigned int row)
+{
+	return const_cast<Code*>(
+	    static_cast<const ObservationCodes&>(*this).getRow<Code>(row));
+}
+
+template <typename Function>
+decltype(auto) ObservationCodes::visit(Function&& f) const
+{
+	switch(width_) {
+		case 1:
+			return f(std::uint8_t());
+		case 2:
+			return f(std::uint16_t());
+		default:
+			return f(std::uint32_t());
+	}
+}
+
+#endif
@@ -0,0 +1,299 @@
+#include "ObservationStream.h"
+
+#include "DiscretisationFactory.h"
+#include "Discretiser.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <type_traits>
+
+namespace
+{
+/**
+ * Reads the tokens of an observation file through a buffer of fixed size,
+ * such that a line is never held in memory as a whole. Tokens are separated
+ * by tabs and spaces like in Matrix::readMatrix.
+ */
+class TokenReader
+{
+	public:
+	explicit TokenReader(std::FILE* file)
+	    : file_(file), bufferStart_(0), begin_(0), end_(0)
+	{
+	}
+
+	// Position of the next character in the file
+	long tell() const { return bufferStart_ + static_cast<long>(begin_); }
+
+	void seek(long position)
+	{
+		if(std::fseek(file_, position, SEEK_SET) != 0) {
+			throw std::invalid_argument("Could not read the observations");
+		}
+		bufferStart_ = position;
+		begin_ = 0;
+		end_ = 0;
+	}
+
+	// Reads the next token of the current line, false at the end of the line
+	bool readToken(std::string& token)
+	{
+		while(fill_() && isDelimiter(buffer_[begin_])) {
+			++begin_;
+		}
+		if(!fill_() || buffer_[begin_] == '\n') {
+			return false;
+		}
+		token.clear();
+		while(fill_()) {
+			const char* first = buffer_.data() + begin_;
+			const char* bufferEnd = buffer_.data() + end_;
+			const char* last = std::find_if(first, bufferEnd, [](char c) {
+				return c == '\n' || isDelimiter(c);
+			});
+			token.append(first, last);
+			begin_ += last - first;
+			if(begin_ < end_) {
+				break;
+			}
+		}
+		return true;
+	}
+
+	// Moves behind the end of the current line, false at the end of the file
+	bool nextLine()
+	{
+		while(fill_()) {
+			const char* first = buffer_.data() + begin_;
+			const char* last = buffer_.data() + end_;
+			const char* lineEnd = std::find(first, last, '\n');
+			begin_ += lineEnd - first;
+			if(lineEnd != last) {
+				++begin_;
+				return fill_();
+			}
+		}
+		return false;
+	}
+
+	private:
+	static bool isDelimiter(char c) { return c == '\t' || c == ' '; }
+
+	// Refills the buffer if it is exhausted, false at the end of the file
+	bool fill_()
+	{
+		if(begin_ < end_) {
+			return true;
+		}
+		bufferStart_ += static_cast<long>(end_);
+		begin_ = 0;
+		end_ = std::fread(buffer_.data(), 1, buffer_.size(), file_);
+		return end_ > 0;
+	}
+
+	std::FILE* file_;
+	std::array<char, 1 << 16> buffer_;
+	// Position of the buffer in the file
+	long bufferStart_;
+	size_t begin_;
+	size_t end_;
+};
+
+// Number of codes written to the temporary file at once
+constexpr size_t codeBlockSize = 1 << 14;
+
+// Discretises the values of the current line and appends their codes to file,
+// seen receives a flag for every occurring code
+template <typename Code>
+void writeCodes(TokenReader& reader, const Discretisations& discretisation,
+                int maxValue, std::FILE* file, std::vector<bool>& seen)
+{
+	std::vector<Code> block;
+	block.reserve(codeBlockSize);
+	const auto flush = [&]() {
+		if(std::fwrite(block.data(), sizeof(Code), block.size(), file) !=
+		   block.size()) {
+			throw std::invalid_argument(
+			    "Could not write the discretised observations");
+		}
+		block.clear();
+	};
+	seen.assign(static_cast<size_t>(maxValue) + 2, false);
+	std::string token;
+	while(reader.readToken(token)) {
+		Discretiser::adaptFormat(token);
+		const int value = discretisation.discretise(token);
+		if(value < Discretisations::NA || value > maxValue) {
+			throw std::invalid_argument("Invalid discretised value " +
+			                            std::to_string(value));
+		}
+		block.push_back(static_cast<Code>(value + 1));
+		seen[value + 1] = true;
+		if(block.size() == codeBlockSize) {
+			flush();
+		}
+	}
+	flush();
+}
+
+// Reads count codes of type Source into the wider or equally wide codes
+template <typename Source, typename Code>
+bool readCodes(std::FILE* file, unsigned int count, Code* destination)
+{
+	if constexpr(std::is_same<Source, Code>::value) {
+		return std::fread(destination, sizeof(Code), count, file) == count;
+	} else {
+		std::vector<Source> buffer(count);
+		if(std::fread(buffer.data(), sizeof(Source), count, file) != count) {
+			return false;
+		}
+		std::copy(buffer.begin(), buffer.end(), destination);
+		return true;
+	}
+}
+}
+
+ObservationStream::ObservationStream(const std::string& datafile,
+                                     const DiscretisationSettings& settings,
+                                     Network& network)
+    : file_(std::tmpfile()), sampleCount_(0), maxValue_(-1)
+{
+	CT_TRACE_SCOPE("ObservationStream::ObservationStream");
+	if(!file_) {
+		throw std::invalid_argument(
+		    "Could not create a temporary file for the observations");
+	}
+	const std::unique_ptr<std::FILE, FileCloser> input(
+	    std::fopen(datafile.c_str(), "rb"));
+	if(!input) {
+		throw std::invalid_argument("File not found");
+	}
+
+	DiscretisationFactory factory(settings);
+	TokenReader reader(input.get());
+	std::string name;
+	std::string token;
+	std::vector<bool> seen;
+	do {
+		if(!reader.readToken(name)) {
+			continue;
+		}
+		const unsigned int row = rowNames_.size();
+		const long valuesStart = reader.tell();
+
+		// First pass: statistics of the row
+		auto discretisation = factory.create(name);
+		unsigned int count = 0;
+		while(reader.readToken(token)) {
+			Discretiser::adaptFormat(token);
+			discretisation->addValue(token);
+			++count;
+		}
+		if(row == 0) {
+			sampleCount_ = count;
+		} else if(count != sampleCount_) {
+			throw std::invalid_argument(
+			    "Row " + std::to_string(row + 1) +
+			    " does not contain the specified number of samples");
+		}
+		const int maxValue = discretisation->finishValues();
+		const unsigned int width = ObservationCodes::getWidthFor(maxValue);
+
+		// Second pass: the codes, written with the width the row requires
+		reader.seek(valuesStart);
+		rowOffsets_.push_back(
+		    rowOffsets_.empty()
+		        ? 0
+		        : rowOffsets_.back() +
+		              static_cast<long>(rowWidths_.back()) * sampleCount_);
+		rowWidths_.push_back(width);
+		switch(width) {
+			case 1:
+				writeCodes<std::uint8_t>(reader, *discretisation, maxValue,
+				                         file_.get(), seen);
+				break;
+			case 2:
+				writeCodes<std::uint16_t>(reader, *discretisation, maxValue,
+				                          file_.get(), seen);
+				break;
+			default:
+				writeCodes<std::uint32_t>(reader, *discretisation, maxValue,
+				                          file_.get(), seen);
+				break;
+		}
+
+		std::vector<int> uniqueValues;
+		for(size_t code = 0; code < seen.size(); code++) {
+			if(seen[code]) {
+				uniqueValues.push_back(static_cast<int>(code) - 1);
+			}
+		}
+		discretisation->nameValues(uniqueValues, row,
+		                           network.getObservationsMap(),
+		                           network.getObservationsMapR());
+		if(!uniqueValues.empty()) {
+			maxValue_ = std::max(maxValue_, uniqueValues.back());
+		}
+		rowNames_.push_back(name);
+		uniqueValues_.push_back(std::move(uniqueValues));
+	} while(reader.nextLine());
+}
+
+unsigned int ObservationStream::getSampleCount() const { return sampleCount_; }
+
+const std::vector<std::string>& ObservationStream::getRowNames() const
+{
+	return rowNames_;
+}
+
+const std::vector<std::vector<int>>& ObservationStream::getUniqueValues() const
+{
+	return uniqueValues_;
+}
+
+void ObservationStream::readSamples(unsigned int first, unsigned int count,
+                                    ObservationCodes& chunk) const
+{
+	if(first > sampleCount_ || count > sampleCount_ - first) {
+		throw std::invalid_argument("The samples exceed the observations");
+	}
+	if(chunk.getColCount() != count ||
+	   chunk.getRowCount() != rowNames_.size() ||
+	   chunk.getWidth() != ObservationCodes::getWidthFor(maxValue_)) {
+		chunk = ObservationCodes(count, rowNames_, maxValue_);
+	}
+	if(count == 0) {
+		return;
+	}
+	// A chunk consists of one contiguous piece per row, which is widened to
+	// the codes of the chunk if necessary
+	chunk.visit([&](auto code) {
+		using Code = decltype(code);
+		for(unsigned int row = 0; row < rowNames_.size(); row++) {
+			const long offset = rowOffsets_[row] +
+			                    static_cast<long>(rowWidths_[row]) * first;
+			Code* destination = chunk.getRow<Code>(row);
+			bool read = std::fseek(file_.get(), offset, SEEK_SET) == 0;
+			switch(rowWidths_[row]) {
+				case 1:
+					read = read && readCodes<std::uint8_t>(file_.get(), count,
+					                                       destination);
+					break;
+				case 2:
+					read = read && readCodes<std::uint16_t>(file_.get(), count,
+					                                        destination);
+					break;
+				default:
+					read = read && readCodes<std::uint32_t>(file_.get(), count,
+					                                        destination);
+					break;
+			}
+			if(!read) {
+				throw std::invalid_argument(
+				    "Could not read the discretised observations");
+			}
+		}
+	});
+}
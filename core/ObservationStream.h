@@ -0,0 +1,93 @@
+#ifndef OBSERVATIONSTREAM_H
+#define OBSERVATIONSTREAM_H
+
+#include "DiscretisationSettings.h"
+#include "Network.h"
+#include "ObservationCodes.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Discretised observations that are kept in a temporary file instead of
+ * memory. Every row, i.e. feature, of the observation file is read twice
+ * through a buffer of fixed size: the first pass collects the statistics of
+ * the discretisation method, the second one writes the codes block by block.
+ * Hence, the memory does not grow with the number of samples. The exceptions
+ * are methods numbering the distinct values of a row, i.e. the rounding
+ * methods and none, whose memory grows with the number of distinct values.
+ * Quantile based methods use a quantile sketch, so their borders are exact up
+ * to 8192 samples and approximate beyond. Afterwards, the samples are read
+ * back in chunks of observation codes.
+ */
+class ObservationStream
+{
+	public:
+	/**ObservationStream
+	 *
+	 * @param datafile, file containing the raw sample data
+	 * @param settings, parameters used for discretisation
+	 * @param network, a reference to the network, which receives the
+	 * original names of the discretised values
+	 *
+	 * @throw invalid_argument if the file can not be read or a row does not
+	 * contain the number of samples of the first row
+	 */
+	ObservationStream(const std::string& datafile,
+	                  const DiscretisationSettings& settings,
+	                  Network& network);
+
+	ObservationStream(const ObservationStream&) = delete;
+	ObservationStream& operator=(const ObservationStream&) = delete;
+
+	/**getSampleCount
+	 *
+	 * @return the number of samples
+	 */
+	unsigned int getSampleCount() const;
+
+	/**getRowNames
+	 *
+	 * @return the names of the rows in the order of the file
+	 */
+	const std::vector<std::string>& getRowNames() const;
+
+	/**getUniqueValues
+	 *
+	 * @return the sorted discretised values of every row, including -1 if
+	 * the row contains missing values
+	 */
+	const std::vector<std::vector<int>>& getUniqueValues() const;
+
+	/**readSamples
+	 *
+	 * @param first, index of the first sample to read
+	 * @param count, number of samples to read
+	 * @param chunk, receives the discretised samples, one column per sample.
+	 * It is resized to count columns and one row per row of the file.
+	 *
+	 * @throw invalid_argument if the samples exceed the observations
+	 */
+	void readSamples(unsigned int first, unsigned int count,
+	                 ObservationCodes& chunk) const;
+
+	private:
+	struct FileCloser {
+		void operator()(std::FILE* file) const { std::fclose(file); }
+	};
+
+	// Temporary file containing the codes of the rows one after another.
+	// Every row is stored with the width required by its own values.
+	std::unique_ptr<std::FILE, FileCloser> file_;
+	std::vector<long> rowOffsets_;
+	std::vector<unsigned int> rowWidths_;
+	unsigned int sampleCount_;
+	// Largest value of all rows
+	int maxValue_;
+	std::vector<std::string> rowNames_;
+	std::vector<std::vector<int>> uniqueValues_;
+};
+
+#endif
@@ -1,9 +1,12 @@
 #include "Parser.h"
 
+#include "Trace.h"
+
 #include "boost/tokenizer.hpp"
 
 QueryExecuter Parser::parseQuery()
 {
+	CT_TRACE_SCOPE("Parser::parseQuery");
 	unsigned int index = 0;
 	if(query_[index] != "?") {
 		throw std::invalid_argument("In parseQuery, query should start with ?");
@@ -1,7 +1,18 @@
 #include "ProbabilityHandler.h"
 #include "Combinations.h"
+#include "Profiling.h"
 
-ProbabilityHandler::ProbabilityHandler(Network& network) : network_(network) {}
+ProbabilityHandler::ProbabilityHandler(Network& network)
+    : network_(network),
+      ownArena_(std::make_unique<QueryArena>()),
+      arena_(*ownArena_)
+{
+}
+
+ProbabilityHandler::ProbabilityHandler(Network& network, QueryArena& arena)
+    : network_(network), arena_(arena)
+{
+}
 
 float ProbabilityHandler::computeTotalProbabilityNormalized(int nodeID,
                                                             int index)
@@ -23,14 +34,16 @@ float ProbabilityHandler::computeTotalProbabilityNormalized(int nodeID,
 
 		for(unsigned int row = 0; row < probMatrix.getRowCount(); row++) {
 			if(node.isCalculated(index, row)) {
+				CT_PROFILE_COUNT(cacheHits, 1);
 				queryResult += node.getCalculatedValue(index, row);
 			} else {
+				CT_PROFILE_COUNT(cacheMisses, 1);
 				float temp = 1.0f;
 				for(unsigned int index2 = 0; index2 < node.getNumberOfParents();
 				    index2++) {
 					temp *= computeTotalProbability(
 					    parentIDs[index2],
-					    network_.reverseFactor(node,index2,row));
+					    node.getParentValue(row, index2));
 				}
 				queryResult += (temp * probMatrix(index, row));
 			}
@@ -69,14 +82,16 @@ float ProbabilityHandler::computeTotalProbability(int nodeID, int index)
 		float result = 0.0f;
 		for(unsigned int row = 0; row < probMatrix.getRowCount(); row++) {
 			if(node.isCalculated(index, row)) {
+				CT_PROFILE_COUNT(cacheHits, 1);
 				result += node.getCalculatedValue(index, row);
 			} else {
+				CT_PROFILE_COUNT(cacheMisses, 1);
 				float temp = 1.0f;
 				for(unsigned int index2 = 0; index2 < node.getNumberOfParents();
 				    index2++) {
 					temp *= computeTotalProbability(
 					    parentIDs[index2],
-					    network_.reverseFactor(node, index2, row));
+					    node.getParentValue(row, index2));
 				}
 				float tempResult = temp * probMatrix(index, row);
 				node.setCalculatedValue(tempResult, index, row);
@@ -92,12 +107,81 @@ float ProbabilityHandler::computeTotalProbability(int nodeID, int index)
 std::vector<unsigned int> ProbabilityHandler::createFactorisation(
     const std::vector<unsigned int>& queryNodes)
 {
-	std::vector<unsigned int> visitedNodes;
-	network_.setAllUnvisited();
-	for(auto& id : queryNodes) {
-		network_.performDFS(id, visitedNodes);
+	boost::dynamic_bitset<> relevant(network_.size());
+	for(auto id : queryNodes) {
+		relevant.set(id);
+		relevant |= network_.getAncestors(id);
+	}
+	// Children are listed before their parents
+	std::vector<unsigned int> factorisation;
+	factorisation.reserve(relevant.count());
+	const auto& order = network_.getTopologicalOrder();
+	for(auto it = order.rbegin(); it != order.rend(); ++it) {
+		if(relevant[*it]) {
+			factorisation.push_back(*it);
+		}
+	}
+	return factorisation;
+}
+
+std::vector<unsigned int> ProbabilityHandler::pruneFactorisation(
+    const std::vector<unsigned int>& factorisation,
+    const std::vector<unsigned int>& queryNodes,
+    const std::vector<int>& evidence)
+{
+	std::pmr::memory_resource* resource = arena_.resource();
+	// The factorisation is closed under ancestors, hence it suffices to know
+	// the children within the factorisation
+	std::pmr::vector<std::pmr::vector<unsigned int>> children(evidence.size(),
+	                                                          resource);
+	for(auto id : factorisation) {
+		for(auto pid : network_.getNode(id).getParents()) {
+			children[pid].push_back(id);
+		}
+	}
+
+	const unsigned char top = 1;
+	const unsigned char bottom = 2;
+	std::pmr::vector<unsigned char> marks(evidence.size(), 0, resource);
+	// Scheduled visits, the flag indicates a visit from a child
+	std::pmr::vector<std::pair<unsigned int, bool>> schedule(resource);
+	for(auto id : queryNodes) {
+		schedule.emplace_back(id, true);
+	}
+	while(!schedule.empty()) {
+		const auto visit = schedule.back();
+		schedule.pop_back();
+		const unsigned int id = visit.first;
+		const bool observed = evidence[id] != -1;
+		// The ball passes through unobserved nodes and bounces back from
+		// observed nodes if it arrives from a parent
+		const bool up = visit.second ? !observed : observed;
+		const bool down = !observed;
+		if(up && !(marks[id] & top)) {
+			marks[id] |= top;
+			for(auto pid : network_.getNode(id).getParents()) {
+				schedule.emplace_back(pid, true);
+			}
+		}
+		if(down && !(marks[id] & bottom)) {
+			marks[id] |= bottom;
+			for(auto cid : children[id]) {
+				schedule.emplace_back(cid, false);
+			}
+		}
+	}
+
+	// Only nodes marked on top contribute their CPT
+	for(auto id : queryNodes) {
+		marks[id] |= top;
+	}
+	std::vector<unsigned int> result;
+	for(auto id : factorisation) {
+		if(marks[id] & top) {
+			result.push_back(id);
+		}
 	}
-	return visitedNodes;
+	return result;
 }
 
 std::vector<std::vector<int>>
@@ -116,64 +200,94 @@ ProbabilityHandler::assignValues(const std::vector<unsigned int>& factorisation,
 	return possibleValueMap;
 }
 
-std::vector<std::vector<int>> ProbabilityHandler::enumerate(
+CombinationCounter<int> ProbabilityHandler::enumerate(
     const std::vector<unsigned int>& factorisation,
-    const std::vector<std::vector<int>>& valueAssignment)
+    const std::vector<std::vector<int>>& valueAssignment,
+    std::vector<int>& assignment) const
 {
-	Combinations<int> com(factorisation, valueAssignment);
-	com.createCombinations(0);
-	return com.getResult();
+	return CombinationCounter<int>(factorisation, valueAssignment, assignment);
 }
 
-int ProbabilityHandler::getParentValues(const Node& n, const Matrix<int>& obs,
-                                        unsigned int sample) const
+float ProbabilityHandler::calculateLikelihoodOfTheData(const Matrix<int>& obs)
+    const
 {
-	const auto& parents = n.getParents();
+	return calculateLikelihoodOfTheData(ObservationCodes(obs));
+}
 
-	int pos = 0;
-	for(unsigned int i = 0; i< parents.size(); i++) {
-		const Node& parent = network_.getNode(parents[i]);
-		pos += n.getFactor(i)*
-		       obs(sample, parent.getObservationRow());
+float ProbabilityHandler::calculateLikelihoodOfTheData(
+    const ObservationCodes& obs) const
+{
+	if (obs.getColCount() > 0){
+		return log(calculateProbabilityOfTheSamples(obs));
 	}
+	else {
+		throw std::invalid_argument("No samples provided");
+	}
+}
 
-	return pos;
+float ProbabilityHandler::calculateProbabilityOfTheSamples(
+    const ObservationCodes& obs) const
+{
+	return obs.visit([&](auto code) {
+		return sumSampleProbabilities<decltype(code)>(obs);
+	});
 }
 
-float ProbabilityHandler::calculateLikelihoodOfTheData(const Matrix<int>& obs)
-    const
+template <typename Code>
+float ProbabilityHandler::sumSampleProbabilities(const ObservationCodes& obs) const
 {
-	if (obs.getColCount() > 0){
-		float prob = 0.0f;
+	// A sample is skipped if any of its values is missing
+	std::vector<bool> complete(obs.getColCount(), true);
+	for(unsigned int row = 0; row < obs.getRowCount(); row++) {
+		const Code* codes = obs.getRow<Code>(row);
 		for(unsigned int sample = 0; sample < obs.getColCount(); sample++) {
-	
-			if(!obs.containsElement(0, sample, -1)) {
-				float intermediateResult = 1.0f;
-	
-				for(const Node& n : network_.getNodes()) {
-					int row = getParentValues(n, obs, sample);
-					intermediateResult *=
-					    n.getProbability(obs(sample, n.getObservationRow()), row);
-				}
-
-				prob += intermediateResult;
+			if(codes[sample] == ObservationCodes::NA) {
+				complete[sample] = false;
 			}
 		}
-		return log(prob);
 	}
-	else {
-		throw std::invalid_argument("No samples provided");
+
+	const auto& nodes = network_.getNodes();
+	std::vector<const Code*> nodeCodes(nodes.size());
+	std::vector<std::vector<const Code*>> parentCodes(nodes.size());
+	for(size_t i = 0; i < nodes.size(); i++) {
+		nodeCodes[i] = obs.getRow<Code>(nodes[i].getObservationRow());
+		for(const auto& parent : nodes[i].getParents()) {
+			parentCodes[i].push_back(
+			    obs.getRow<Code>(network_.getNode(parent).getObservationRow()));
+		}
+	}
+
+	float prob = 0.0f;
+	for(unsigned int sample = 0; sample < obs.getColCount(); sample++) {
+
+		if(complete[sample]) {
+			float intermediateResult = 1.0f;
+
+			for(size_t i = 0; i < nodes.size(); i++) {
+				int row = 0;
+				for(unsigned int p = 0; p < parentCodes[i].size(); p++) {
+					row += nodes[i].getFactor(p) * (parentCodes[i][p][sample] - 1);
+				}
+				intermediateResult *=
+				    nodes[i].getProbability(nodeCodes[i][sample] - 1, row);
+			}
+
+			prob += intermediateResult;
+		}
 	}
+	return prob;
 }
 
-std::vector<Factor> ProbabilityHandler::createFactorList(
+std::pmr::vector<Factor> ProbabilityHandler::createFactorList(
     const std::vector<unsigned int>& factorisation,
-    const std::vector<int>& values) const
+    const std::vector<int>& values)
 {
-	std::vector<Factor> temp;
+	CT_PROFILE_TIMER(constructionTime);
+	std::pmr::vector<Factor> temp(arena_.resource());
 	temp.reserve(factorisation.size());
 	for(auto& id : factorisation) {
-		temp.push_back(Factor(network_.getNode(id), values));
+		temp.emplace_back(network_.getNode(id), values, arena_.resource());
 	}
 	return temp;
 }
@@ -212,21 +326,24 @@ std::vector<unsigned int> ProbabilityHandler::getOrdering(
 }
 
 void ProbabilityHandler::eliminate(const unsigned int id,
-                                   std::vector<Factor>& factorlist,
+                                   std::pmr::vector<Factor>& factorlist,
                                    const std::vector<int>& values,
 									const std::vector<int>& nonInterventionValues = {})
 {
-	std::vector<unsigned int> neededFactors;
-	std::vector<std::vector<unsigned int>> neededFactorsIDs;
+	CT_PROFILE_TIMER(eliminationTime);
+	std::pmr::vector<unsigned int> neededFactors(arena_.resource());
 	for(unsigned int i = 0; i < factorlist.size(); i++) {
 		Factor& f = factorlist[i];
 		if(std::find(f.getIDs().begin(), f.getIDs().end(), id) !=
 		   f.getIDs().end()) {
 			neededFactors.push_back(i);
-			neededFactorsIDs.push_back(f.getIDs());
 		}
 	}
-	Factor tempFactor = factorlist[neededFactors[0]];
+	if(neededFactors.empty()) {
+		return;
+	}
+	CT_PROFILE_COUNT(eliminations, 1);
+	Factor tempFactor = std::move(factorlist[neededFactors[0]]);
 	if(neededFactors.size() > 1) {
 		for(unsigned int i = 1; i < neededFactors.size(); i++) {
 			tempFactor = tempFactor.product(factorlist[neededFactors[i]],network_,values);
@@ -235,20 +352,18 @@ void ProbabilityHandler::eliminate(const unsigned int id,
 	if (nonInterventionValues.empty() || values[id] != -1 || (values[id] == -1 && nonInterventionValues[id] == -1)) {
 		tempFactor = tempFactor.sumOut(id, network_, values);
 	}
-	for(auto& neededFactorID : neededFactorsIDs) {
-		auto it = factorlist.begin();
-		for(; it != factorlist.end();) {
-			if(it->getIDs() == neededFactorID) {
-				it = factorlist.erase(it);
-			} else {
-				++it;
-			}
+	// The order of the factors does not matter, hence the used factors are
+	// removed by swapping them to the back, starting with the last one
+	for(auto it = neededFactors.rbegin(); it != neededFactors.rend(); ++it) {
+		if(*it + 1 != factorlist.size()) {
+			std::swap(factorlist[*it], factorlist.back());
 		}
+		factorlist.pop_back();
 	}
-	factorlist.push_back(tempFactor);
+	factorlist.push_back(std::move(tempFactor));
 }
 
-float ProbabilityHandler::getResult(std::vector<Factor>& factorlist)
+float ProbabilityHandler::getResult(std::pmr::vector<Factor>& factorlist)
 {
 	float prob = 1.0f;
 	for(auto& f : factorlist) {
@@ -258,10 +373,13 @@ float ProbabilityHandler::getResult(std::vector<Factor>& factorlist)
 }
 
 
-float ProbabilityHandler::getResult(std::vector<Factor>& factorlist, const std::vector<int>& values)
+float ProbabilityHandler::getResult(std::pmr::vector<Factor>& factorlist, const std::vector<int>& values)
 {
-	for(auto& f : factorlist) {
-		f.normalize();
+	{
+		CT_PROFILE_TIMER(normalisationTime);
+		for(auto& f : factorlist) {
+			f.normalize();
+		}
 	}
 	float prob = 1.0f;
 	for (auto& f: factorlist){
@@ -275,6 +393,7 @@ float ProbabilityHandler::getResult(std::vector<Factor>& factorlist, const std::
 float ProbabilityHandler::computeJointProbabilityUsingVariableElimination(
     const std::vector<unsigned int>& queryNodes, const std::vector<int>& values)
 {
+	QueryArenaGuard guard(arena_);
 	auto factorisation = createFactorisation(queryNodes);
 	auto factorlist = createFactorList(factorisation, values);
 	auto ordering = getOrdering(factorisation, queryNodes);
@@ -290,9 +409,11 @@ float ProbabilityHandler::computeConditionalProbability(
     const std::vector<int>& valuesNonIntervention,
     const std::vector<int>& valuesCondition)
 {	
+	QueryArenaGuard guard(arena_);
 	auto allNodes = nodesNonIntervention;
 	allNodes.insert(allNodes.end(), nodesCondition.begin(), nodesCondition.end());
-	auto factorisation = createFactorisation(allNodes);
+	auto factorisation = pruneFactorisation(createFactorisation(allNodes),
+	                                        nodesNonIntervention, valuesCondition);
 	auto factorlist = createFactorList(factorisation, valuesCondition);
 	auto ordering = getOrdering(factorisation, nodesCondition, nodesNonIntervention);
 	for (auto& id : ordering) {
@@ -301,6 +422,18 @@ float ProbabilityHandler::computeConditionalProbability(
 	return getResult(factorlist,valuesNonIntervention);
 }
 
+std::vector<unsigned int> ProbabilityHandler::getRequiredNodes(
+    const std::vector<unsigned int>& nodesNonIntervention,
+    const std::vector<unsigned int>& nodesCondition,
+    const std::vector<int>& valuesCondition)
+{
+	QueryArenaGuard guard(arena_);
+	auto allNodes = nodesNonIntervention;
+	allNodes.insert(allNodes.end(), nodesCondition.begin(), nodesCondition.end());
+	return pruneFactorisation(createFactorisation(allNodes),
+	                          nodesNonIntervention, valuesCondition);
+}
+
 std::pair<float, std::vector<std::string>>
 ProbabilityHandler::maxSearch(const std::vector<unsigned int>& queryNodes,
                               const std::vector<unsigned int>& conditionNodes = {},
@@ -309,55 +442,46 @@ ProbabilityHandler::maxSearch(const std::vector<unsigned int>& queryNodes,
 	std::vector<int> emptyValues(network_.size(), -1);
 	std::vector<std::vector<int>> queryAssignment =
 	    assignValues(queryNodes, emptyValues);
-	std::vector<std::vector<int>> combinations =
-	    enumerate(queryNodes, queryAssignment);
+	CombinationCounter<int> combinations =
+	    enumerate(queryNodes, queryAssignment, emptyValues);
+	if(combinations.empty()) {
+		throw std::invalid_argument("A query node does not contain any value");
+	}
 
-	int index = 0;
-	int maxIndex = 0;
+	std::vector<unsigned int> maxDigits = combinations.getDigits();
 	float maxprob = 0.0f;
 
-	if(queryNodes.size() > 1) {
-		for(auto& com : combinations) {
-			float prob = 0.0f;
-			for(auto& id : queryNodes) {
-				emptyValues[id] = com[id];
-			}
-			if (conditionNodes.empty()) {
+	do {
+		float prob = 0.0f;
+		if(queryNodes.size() > 1) {
+			if(conditionNodes.empty()) {
 				prob = computeJointProbabilityUsingVariableElimination(
 				    queryNodes, emptyValues);
 			} else {
 				prob = computeConditionalProbability(
 				    queryNodes, conditionNodes, emptyValues, conditionValues);
 			}
-			if(prob > maxprob) {
-				maxprob = prob;
-				maxIndex = index;
-			}
-			index++;
-		}
-	} else {
-		for(auto& com : combinations) {
-			float prob = 0.0f;
+		} else {
 			if(conditionNodes.empty()) {
-				prob =
-				    computeTotalProbabilityNormalized(queryNodes[0], com[queryNodes[0]]);
+				prob = computeTotalProbabilityNormalized(
+				    queryNodes[0], emptyValues[queryNodes[0]]);
 			} else {
-				emptyValues[queryNodes[0]]=com[queryNodes[0]];
 				prob = computeConditionalProbability(
 				    {queryNodes[0]}, conditionNodes, emptyValues,
 				    conditionValues);
 			}
-			if(prob > maxprob) {
-				maxprob = prob;
-				maxIndex = index;
-			}
-			index++;
 		}
-	}
+		if(prob > maxprob) {
+			maxprob = prob;
+			maxDigits = combinations.getDigits();
+		}
+	} while(combinations.next());
+
+	combinations.setDigits(maxDigits);
 	std::vector<std::string> resultNames;
 
 	for(auto& id : queryNodes) {
-		int value = combinations[maxIndex][id];
+		int value = emptyValues[id];
 		const Node& node = network_.getNode(id);
 		resultNames.push_back(node.getValueNamesProb()[value]);
 	}
@@ -3,6 +3,11 @@
 
 #include "Network.h"
 #include "Factor.h"
+#include "Combinations.h"
+#include "ObservationCodes.h"
+#include "QueryArena.h"
+
+#include <memory>
 
 class ProbabilityHandler
 {
@@ -25,8 +30,19 @@ class ProbabilityHandler
 	 */
 	explicit ProbabilityHandler(Network& network);
 
+	/**ProbabilityHandler
+	 *
+	 * @param network, a reference to the network 
+	 * @param arena, memory arena used for the temporary data of every query
+	 *
+	 * @return ProbabilityHandler object
+	 */
+	ProbabilityHandler(Network& network, QueryArena& arena);
+
 	ProbabilityHandler(const ProbabilityHandler& o)
-		: network_(o.network_)
+		: network_(o.network_),
+		  ownArena_(o.ownArena_ ? std::make_unique<QueryArena>() : nullptr),
+		  arena_(ownArena_ ? *ownArena_ : o.arena_)
 	{
 	}
 
@@ -81,6 +97,20 @@ class ProbabilityHandler
 	    const std::vector<int>& valuesNonIntervention,
 	    const std::vector<int>& valuesCondition);
 
+	/**getRequiredNodes
+	 *
+	 * @param nodesNonIntervention, vector containing the identifiers of the query nodes
+	 * @param nodesCondition, vector containing the evidence nodes
+	 * @param valuesCondition, vector containing the evidence values
+	 *
+	 * @return the nodes whose CPTs computeConditionalProbability turns into
+	 * factors, i.e. the factorisation after d-separated nodes are pruned
+	 */
+	std::vector<unsigned int>
+	getRequiredNodes(const std::vector<unsigned int>& nodesNonIntervention,
+	                 const std::vector<unsigned int>& nodesCondition,
+	                 const std::vector<int>& valuesCondition);
+
 	/**maxSearch
 	 *
 	 * @param queryNodes, vector containing the identifiers of the query nodes
@@ -104,6 +134,26 @@ class ProbabilityHandler
 	 */
 	float calculateLikelihoodOfTheData(const Matrix<int>& obs) const;
 
+	/**calculateLikelihoodOfTheData
+	 *
+	 * @param obs, the discretised observations
+	 *
+	 * @return the log likelihood of the data
+	 *
+	 */
+	float calculateLikelihoodOfTheData(const ObservationCodes& obs) const;
+
+	/**calculateProbabilityOfTheSamples
+	 *
+	 * @param obs, the discretised observations
+	 *
+	 * @return the summed probability of all samples without missing values,
+	 * such that the likelihood of chunked data is the log of the sum over
+	 * all chunks
+	 *
+	 */
+	float calculateProbabilityOfTheSamples(const ObservationCodes& obs) const;
+
 	private:
 
 	/**createFactorisation
@@ -112,11 +162,28 @@ class ProbabilityHandler
 	 *
 	 * @return list of all node identifiers which have to be considered for calculating the user query
 	 *
-	 * The procedure performs DFS for all query nodes to generate the factorisation
+	 * The factorisation contains the query nodes and their ancestors, children are listed before their parents
 	 */
 	std::vector<unsigned int>
 	createFactorisation(const std::vector<unsigned int>& queryNodes);
 
+	/**pruneFactorisation
+	 *
+	 * @param factorisation, factorisation of the query and evidence nodes
+	 * @param queryNodes, identifiers of the query nodes
+	 * @param evidence, vector containing the known values of the evidence nodes
+	 *
+	 * @return the nodes of the factorisation whose CPTs are required to compute
+	 * the distribution of the query nodes given the evidence, including the query nodes
+	 *
+	 * Uses the Bayes-ball algorithm to remove nodes that are d-separated from the
+	 * query nodes given the evidence. Barren nodes are already excluded by createFactorisation.
+	 */
+	std::vector<unsigned int>
+	pruneFactorisation(const std::vector<unsigned int>& factorisation,
+	                   const std::vector<unsigned int>& queryNodes,
+	                   const std::vector<int>& evidence);
+
 	/**assignValues
 	 *
 	 * @param factorisation, factorisation of the query nodes
@@ -134,28 +201,27 @@ class ProbabilityHandler
 	 *
 	 * @param factorisation, factorisation of the query nodes
 	 * @param valueAssignment, value assignment produced by the procedure assignValues
+	 * @param assignment, vector indexed by node identifier receiving the current values
 	 *
-	 * @return An enumeration of all possible value combinations for the nodes
-	 * in the factorisation. This uses the class Combinations.
-	 *
+	 * @return A lazy enumeration of all possible value combinations for the nodes
+	 * in the factorisation. This uses the class CombinationCounter, thus
+	 * the combinations are not materialised.
 	 *
 	 */
-	std::vector<std::vector<int>>
+	CombinationCounter<int>
 	enumerate(const std::vector<unsigned int>& factorisation,
-	          const std::vector<std::vector<int>>& valueAssignment);
+	          const std::vector<std::vector<int>>& valueAssignment,
+	          std::vector<int>& assignment) const;
 
-	/**getParentValues
-	 *
-	 * @param n,
-	 * @param obs,
-	 * @param index,
-	 *
-	 * @return
+	/**sumSampleProbabilities
 	 *
+	 * @param obs, the discretised observations
 	 *
+	 * @return the summed probability of all samples without missing values.
+	 * Code is the type of the observation codes.
 	 */
-	int getParentValues(const Node& n, const Matrix<int>& obs,
-	                    unsigned int index) const;
+	template <typename Code>
+	float sumSampleProbabilities(const ObservationCodes& obs) const;
 
 	/**getResult
 	 *
@@ -165,7 +231,7 @@ class ProbabilityHandler
 	 *
 	 * This method is used if joint probabilities are computed
 	 */
-	float getResult(std::vector<Factor>& factorlist);
+	float getResult(std::pmr::vector<Factor>& factorlist);
 	
 	/**getResult
 	 *
@@ -176,7 +242,7 @@ class ProbabilityHandler
 	 *
 	 * This method is used if conditional probabilities are computed
 	 */
-	float getResult(std::vector<Factor>& factorlist,
+	float getResult(std::pmr::vector<Factor>& factorlist,
 	                const std::vector<int>& values);
 
 	/**createFactorList
@@ -185,12 +251,12 @@ class ProbabilityHandler
 	 * @param values, vector containig the values entered by the user
 	 *
 	 * @return a vector of factors for all nodes in the factorisation with respect
-	 * to the given values
+	 * to the given values. The factors are allocated in the query arena.
 	 *
 	 */
-	std::vector<Factor>
+	std::pmr::vector<Factor>
 	createFactorList(const std::vector<unsigned int>& factorisation,
-	                 const std::vector<int>& values) const;
+	                 const std::vector<int>& values);
 
 	/**getOrdering
 	 *
@@ -225,14 +291,20 @@ class ProbabilityHandler
 	 * @param nonInterventionValues, vector of values for non evidence nodes
 	 *
 	 * Performs the elimination operation using the product and sumOut
-	 * methods in the class Factor
+	 * methods in the class Factor. Nothing happens if no factor contains id.
 	 */
-	void eliminate(const unsigned int id, std::vector<Factor>& factorlist,
+	void eliminate(const unsigned int id, std::pmr::vector<Factor>& factorlist,
 	               const std::vector<int>& values,
 	               const std::vector<int>& nonInterventionValues);
 
 	//A reference to the network
 	Network& network_;
+
+	//Arena owned by this object if none is provided
+	std::unique_ptr<QueryArena> ownArena_;
+
+	//Memory arena for the factors of a single query
+	QueryArena& arena_;
 };
 
 #endif
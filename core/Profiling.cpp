@@ -0,0 +1,52 @@
+#include "Profiling.h"
+
+#include <iostream>
+
+namespace
+{
+thread_local QueryStats* currentStats = nullptr;
+
+double toMilliSeconds(std::chrono::nanoseconds time)
+{
+	return std::chrono::duration<double, std::milli>(time).count();
+}
+}
+
+std::ostream& operator<<(std::ostream& os, const QueryStats& stats)
+{
+	os << "Total time: " << toMilliSeconds(stats.totalTime) << "ms\n";
+	if(!Profiling::enabled) {
+		return os << "Detailed statistics require a build with "
+		             "CAUSALTRAIL_PROFILING\n";
+	}
+	os << "Factors created: " << stats.factorsCreated << "\n"
+	   << "Factor products: " << stats.products << " ("
+	   << stats.productEntries << " entries)\n"
+	   << "Eliminations: " << stats.eliminations << "\n"
+	   << "Largest factor: " << stats.maxFactorSize << " entries\n"
+	   << "DP cache hits/misses: " << stats.cacheHits << "/"
+	   << stats.cacheMisses << "\n"
+	   << "Factor construction: " << toMilliSeconds(stats.constructionTime)
+	   << "ms\n"
+	   << "Elimination: " << toMilliSeconds(stats.eliminationTime) << "ms\n"
+	   << "Normalisation: " << toMilliSeconds(stats.normalisationTime)
+	   << "ms\n";
+	return os;
+}
+
+namespace Profiling
+{
+QueryStats* activeStats() { return currentStats; }
+
+QueryScope::QueryScope(QueryStats& stats)
+    : stats_(stats), previous_(currentStats), start_(Clock::now())
+{
+	currentStats = &stats_;
+}
+
+QueryScope::~QueryScope()
+{
+	stats_.totalTime += Clock::now() - start_;
+	currentStats = previous_;
+}
+}
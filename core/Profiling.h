@@ -0,0 +1,145 @@
+#ifndef PROFILING_H
+#define PROFILING_H
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+
+/**
+ * Counters and timers collected while a query is executed. Apart from the
+ * total time, the statistics are only filled if CausalTrail is built with
+ * CAUSALTRAIL_PROFILING, otherwise the instrumentation compiles to nothing.
+ */
+struct QueryStats {
+	// Number of factors created from the CPTs
+	uint64_t factorsCreated = 0;
+	// Number of factor products
+	uint64_t products = 0;
+	// Number of entries of all factors created by products
+	uint64_t productEntries = 0;
+	// Number of eliminated variables
+	uint64_t eliminations = 0;
+	// Number of entries of the largest factor
+	uint64_t maxFactorSize = 0;
+	// Lookups in the dynamic programming matrices of the nodes
+	uint64_t cacheHits = 0;
+	uint64_t cacheMisses = 0;
+	// Time spent creating the factors from the CPTs
+	std::chrono::nanoseconds constructionTime{0};
+	// Time spent multiplying and summing out factors
+	std::chrono::nanoseconds eliminationTime{0};
+	// Time spent normalising the resulting factors
+	std::chrono::nanoseconds normalisationTime{0};
+	// Wall clock time of the whole query
+	std::chrono::nanoseconds totalTime{0};
+};
+
+/**operator<<
+ *
+ * @param os, reference to an ostream object
+ * @param stats, the statistics to be printed
+ *
+ * @return an ostream reference
+ */
+std::ostream& operator<<(std::ostream& os, const QueryStats& stats);
+
+/**
+ * Duration and parameter difference of a single EM iteration.
+ */
+struct EMIterationStats {
+	std::chrono::nanoseconds time{0};
+	float difference = 0.0f;
+};
+
+namespace Profiling
+{
+#ifdef CAUSALTRAIL_PROFILING
+constexpr bool enabled = true;
+#else
+constexpr bool enabled = false;
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+/**activeStats
+ *
+ * @return the statistics of the query executed by this thread, or nullptr
+ */
+QueryStats* activeStats();
+
+/**
+ * Makes stats the active statistics of this thread for its lifetime and
+ * measures the total time. The previously active statistics are restored
+ * afterwards, such that scopes may be nested.
+ */
+class QueryScope
+{
+	public:
+	explicit QueryScope(QueryStats& stats);
+	~QueryScope();
+
+	QueryScope(const QueryScope&) = delete;
+	QueryScope& operator=(const QueryScope&) = delete;
+
+	private:
+	QueryStats& stats_;
+	QueryStats* previous_;
+	Clock::time_point start_;
+};
+
+/**
+ * Adds the time until its destruction to a timer of the active statistics.
+ */
+class ScopedTimer
+{
+	public:
+	explicit ScopedTimer(std::chrono::nanoseconds QueryStats::*timer)
+	    : stats_(activeStats()), timer_(timer)
+	{
+		if(stats_) {
+			start_ = Clock::now();
+		}
+	}
+
+	~ScopedTimer()
+	{
+		if(stats_) {
+			stats_->*timer_ += Clock::now() - start_;
+		}
+	}
+
+	ScopedTimer(const ScopedTimer&) = delete;
+	ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+	private:
+	QueryStats* stats_;
+	std::chrono::nanoseconds QueryStats::*timer_;
+	Clock::time_point start_;
+};
+}
+
+#ifdef CAUSALTRAIL_PROFILING
+#define CT_PROFILE_COUNT(counter, n)                                   \
+	do {                                                               \
+		if(QueryStats* ctStats_ = Profiling::activeStats()) {          \
+			ctStats_->counter += (n);                                  \
+		}                                                              \
+	} while(false)
+#define CT_PROFILE_MAX(counter, n)                                     \
+	do {                                                               \
+		if(QueryStats* ctStats_ = Profiling::activeStats()) {          \
+			const uint64_t ctValue_ = (n);                             \
+			if(ctValue_ > ctStats_->counter) {                         \
+				ctStats_->counter = ctValue_;                          \
+			}                                                          \
+		}                                                              \
+	} while(false)
+#define CT_PROFILE_TIMER(timer)                                        \
+	Profiling::ScopedTimer ctTimer_(&QueryStats::timer)
+#else
+#define CT_PROFILE_COUNT(counter, n) ((void)0)
+#define CT_PROFILE_MAX(counter, n) ((void)0)
+#define CT_PROFILE_TIMER(timer) ((void)0)
+#endif
+
+#endif
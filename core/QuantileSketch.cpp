@@ -0,0 +1,113 @@
+#include "QuantileSketch.h"
+
+#include "Discretisations.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+QuantileSketch::QuantileSketch(size_t capacity)
+    : capacity_(std::max<size_t>(2, capacity)),
+      size_(0),
+      retained_(0),
+      totalCapacity_(capacity_),
+      levels_(1),
+      keepOdd_(1, false)
+{
+}
+
+size_t QuantileSketch::getLevelCapacity_(size_t level) const
+{
+	const size_t depth = levels_.size() - 1 - level;
+	return std::max<size_t>(
+	    2, static_cast<size_t>(std::ceil(capacity_ * std::pow(2.0 / 3.0, depth))));
+}
+
+void QuantileSketch::add(float value)
+{
+	levels_[0].push_back(value);
+	++size_;
+	++retained_;
+	if(retained_ <= totalCapacity_) {
+		return;
+	}
+	// Compact the lowest level that is full, such that the values of the
+	// stream are summarised as late as possible
+	for(size_t level = 0; level < levels_.size(); level++) {
+		if(levels_[level].size() >= getLevelCapacity_(level)) {
+			compact_(level);
+			break;
+		}
+	}
+}
+
+void QuantileSketch::compact_(size_t level)
+{
+	if(level + 1 == levels_.size()) {
+		levels_.emplace_back();
+		keepOdd_.push_back(false);
+	}
+	std::vector<float>& values = levels_[level];
+	std::sort(values.begin(), values.end());
+	// An odd value stays on the level, such that the weights add up to size_
+	const size_t count = values.size() - values.size() % 2;
+	// Alternating the kept half balances the rank errors of the compactions
+	for(size_t i = keepOdd_[level] ? 1 : 0; i < count; i += 2) {
+		levels_[level + 1].push_back(values[i]);
+	}
+	keepOdd_[level] = !keepOdd_[level];
+	values.erase(values.begin(), values.begin() + count);
+	retained_ -= count / 2;
+
+	totalCapacity_ = 0;
+	for(size_t i = 0; i < levels_.size(); i++) {
+		totalCapacity_ += getLevelCapacity_(i);
+	}
+	// The capacities of the lower levels shrink as levels are added, their
+	// buffers must not keep the memory of larger capacities
+	if(values.capacity() > 2 * getLevelCapacity_(level)) {
+		values.shrink_to_fit();
+	}
+}
+
+size_t QuantileSketch::size() const { return size_; }
+
+bool QuantileSketch::isExact() const { return levels_.size() == 1; }
+
+std::vector<float>
+QuantileSketch::select(const std::vector<size_t>& ranks) const
+{
+	if(isExact()) {
+		std::vector<float> values = levels_[0];
+		return Discretisations::selectOrderStatistics(values, ranks);
+	}
+
+	// Every value of level i stands for 2^i values of the stream
+	std::vector<std::pair<float, unsigned int>> weighted;
+	weighted.reserve(retained_);
+	for(unsigned int level = 0; level < levels_.size(); level++) {
+		for(float value : levels_[level]) {
+			weighted.emplace_back(value, level);
+		}
+	}
+	std::sort(weighted.begin(), weighted.end());
+
+	// The ranks are answered in increasing order in a single sweep
+	std::vector<size_t> order(ranks.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(),
+	          [&ranks](size_t a, size_t b) { return ranks[a] < ranks[b]; });
+	std::vector<float> result(ranks.size(),
+	                          std::numeric_limits<float>::quiet_NaN());
+	size_t next = 0;
+	size_t weight = 0;
+	for(const auto& entry : weighted) {
+		weight += size_t(1) << entry.second;
+		while(next < order.size() && ranks[order[next]] < weight) {
+			result[order[next++]] = entry.first;
+		}
+	}
+	return result;
+}
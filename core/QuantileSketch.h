@@ -0,0 +1,74 @@
+#ifndef QUANTILESKETCH_H
+#define QUANTILESKETCH_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Summary of a stream of values that answers order statistic queries with a
+ * bounded amount of memory, following the KLL sketch of Karnin, Lang and
+ * Liberty. Level i holds values that each stand for 2^i values of the stream.
+ * A full level is sorted and every other value is moved to the next level.
+ * The capacity of the top level is the capacity of the sketch and every level
+ * below holds two thirds of the one above, hence less than three times the
+ * capacity values are kept however many values are added. As long as no more
+ * than capacity values have been added, the answers are exact.
+ */
+class QuantileSketch
+{
+	public:
+	/**QuantileSketch
+	 *
+	 * @param capacity, number of values kept by the top level, at least two
+	 */
+	explicit QuantileSketch(size_t capacity = 8192);
+
+	/**add
+	 *
+	 * @param value, the next value of the stream
+	 */
+	void add(float value);
+
+	/**size
+	 *
+	 * @return the number of values added to the sketch
+	 */
+	size_t size() const;
+
+	/**isExact
+	 *
+	 * @return true if no values have been summarised yet, i.e. select returns
+	 * the exact order statistics
+	 */
+	bool isExact() const;
+
+	/**select
+	 *
+	 * @param ranks, positions in the sorted order of the added values
+	 *
+	 * @return the values at the given ranks of the sorted order, NaN for
+	 * ranks outside of the added values. If the sketch is not exact, the
+	 * rank of a returned value deviates from the requested one by a small
+	 * fraction of the number of values.
+	 */
+	std::vector<float> select(const std::vector<size_t>& ranks) const;
+
+	private:
+	// Number of values the level may hold before it is compacted
+	size_t getLevelCapacity_(size_t level) const;
+
+	// Moves every other value of the level to the next level
+	void compact_(size_t level);
+
+	size_t capacity_;
+	size_t size_;
+	// Number of values kept in all levels
+	size_t retained_;
+	// Sum of the capacities of all levels
+	size_t totalCapacity_;
+	std::vector<std::vector<float>> levels_;
+	// Alternates between keeping the values at even and odd positions
+	std::vector<bool> keepOdd_;
+};
+
+#endif
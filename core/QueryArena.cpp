@@ -0,0 +1,41 @@
+#include "QueryArena.h"
+
+QueryArena::QueryArena(size_t initialSize) : buffer_(initialSize)
+{
+	resource_.emplace(buffer_.data(), buffer_.size(), &overflow_);
+}
+
+std::pmr::memory_resource* QueryArena::resource() { return &*resource_; }
+
+void QueryArena::release()
+{
+	resource_->release();
+	if(overflow_.requested > 0) {
+		// Grow such that the last query would have fit into the buffer
+		const size_t newSize = buffer_.size() + overflow_.requested;
+		overflow_.requested = 0;
+		resource_.reset();
+		buffer_ = std::vector<std::byte>(newSize);
+		resource_.emplace(buffer_.data(), buffer_.size(), &overflow_);
+	}
+}
+
+size_t QueryArena::getCapacity() const { return buffer_.size(); }
+
+void* QueryArena::OverflowResource::do_allocate(size_t bytes, size_t alignment)
+{
+	requested += bytes;
+	return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+}
+
+void QueryArena::OverflowResource::do_deallocate(void* p, size_t bytes,
+                                                 size_t alignment)
+{
+	std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+}
+
+bool QueryArena::OverflowResource::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept
+{
+	return this == &other;
+}
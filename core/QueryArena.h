@@ -0,0 +1,91 @@
+#ifndef QUERYARENA_H
+#define QUERYARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+
+/**
+ * Memory arena for the temporary data of a single query, e.g. factor tables
+ * and scratch buffers. All allocations are served in a monotonic fashion from
+ * a persistent buffer and are freed in one shot by release(). If a query needs
+ * more memory than the buffer provides, the excess is taken from the heap and
+ * the buffer is enlarged on the next release, such that queries of a similar
+ * size do not touch the heap anymore.
+ */
+class QueryArena
+{
+	public:
+	/**QueryArena
+	 *
+	 * @param initialSize, initial size of the buffer in bytes
+	 *
+	 * @return a QueryArena object
+	 */
+	explicit QueryArena(size_t initialSize = 64 * 1024);
+
+	QueryArena(const QueryArena&) = delete;
+	QueryArena& operator=(const QueryArena&) = delete;
+
+	/**resource
+	 *
+	 * @return the memory resource to be used for all allocations of the query
+	 */
+	std::pmr::memory_resource* resource();
+
+	/**release
+	 *
+	 * Frees all memory allocated since the last call in one shot. All objects
+	 * using the arena have to be destroyed beforehand.
+	 */
+	void release();
+
+	/**getCapacity
+	 *
+	 * @return the current size of the persistent buffer in bytes
+	 */
+	size_t getCapacity() const;
+
+	private:
+	/**
+	 * Heap resource used if the buffer is exhausted. It records the number of
+	 * bytes requested, which is used to enlarge the buffer.
+	 */
+	class OverflowResource : public std::pmr::memory_resource
+	{
+		public:
+		size_t requested = 0;
+
+		private:
+		void* do_allocate(size_t bytes, size_t alignment) override;
+		void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+		bool do_is_equal(const std::pmr::memory_resource& other) const
+		    noexcept override;
+	};
+
+	//The persistent buffer
+	std::vector<std::byte> buffer_;
+	//Resource serving allocations that do not fit into the buffer
+	OverflowResource overflow_;
+	//Monotonic resource working on the buffer
+	std::optional<std::pmr::monotonic_buffer_resource> resource_;
+};
+
+/**
+ * Releases the arena when going out of scope. Objects allocated in the arena
+ * have to be declared after the guard.
+ */
+class QueryArenaGuard
+{
+	public:
+	explicit QueryArenaGuard(QueryArena& arena) : arena_(arena) {}
+	QueryArenaGuard(const QueryArenaGuard&) = delete;
+	QueryArenaGuard& operator=(const QueryArenaGuard&) = delete;
+	~QueryArenaGuard() { arena_.release(); }
+
+	private:
+	QueryArena& arena_;
+};
+
+#endif
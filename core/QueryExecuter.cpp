@@ -1,8 +1,9 @@
 #include "QueryExecuter.h"
+#include "Trace.h"
 
 QueryExecuter::QueryExecuter(NetworkController& c)
     : networkController_(c),
-      probHandler_(c.getNetwork()),
+      probHandler_(c.getNetwork(), c.getQueryArena()),
       interventions_(c)
 {
 	size_t size = c.getNetwork().size();
@@ -83,6 +84,7 @@ void QueryExecuter::adaptNodeIdentifiers()
 
 std::pair<float, std::vector<std::string>> QueryExecuter::execute()
 {
+	CT_TRACE_SCOPE("QueryExecuter::execute");
 	if (nonInterventionNodeID_.empty() && argmaxNodeIDs_.empty()) {
 		throw std::invalid_argument("A query can not be composed of interventions and conditions only!");
 	}
@@ -93,23 +95,38 @@ std::pair<float, std::vector<std::string>> QueryExecuter::execute()
 			throw std::invalid_argument("Edge additions and removals are not "
 			                            "defined for counterfactuals");
 		}
+		CT_TRACE_SCOPE("QueryExecuter::createTwinNetwork");
 		networkController_.getNetwork().createTwinNetwork();
 		cf = true;
 		adaptNodeIdentifiers();
 	}
 	if(hasInterventions()) {
+		CT_TRACE_SCOPE("QueryExecuter::executeInterventions");
 		executeInterventions();
 	}
-	probability = computeProbability();
+	{
+		CT_TRACE_SCOPE("QueryExecuter::computeProbability");
+		probability = computeProbability();
+	}
 	if(hasInterventions()) {
+		CT_TRACE_SCOPE("QueryExecuter::reverseInterventions");
 		reverseInterventions();
 	}
 	if(cf) {
+		CT_TRACE_SCOPE("QueryExecuter::removeHypoNodes");
 		networkController_.getNetwork().removeHypoNodes();
 	}
 	return probability;
 }
 
+std::pair<float, std::vector<std::string>>
+QueryExecuter::execute(QueryStats& stats)
+{
+	stats = QueryStats();
+	Profiling::QueryScope scope(stats);
+	return execute();
+}
+
 std::pair<float, std::vector<std::string>> QueryExecuter::computeProbability()
 {
 	std::vector<std::string> temp;
@@ -181,11 +198,11 @@ void QueryExecuter::executeReverseDoInterventions()
 void QueryExecuter::executeEdgeAdditions()
 {
 	for(auto& p : addEdgeNodeIDs_) {
-		interventions_.addEdge(p.first, p.second);
-		if(networkController_.getNetwork().checkCycleExistence(p.first)) {
-			interventions_.removeEdge(p.first, p.second);
+		// Interventions::addEdge makes the source a parent of the target
+		if(networkController_.getNetwork().edgeInducesCycle(p.second, p.first)) {
 			throw std::invalid_argument("This edge induces a cycle");
 		}
+		interventions_.addEdge(p.first, p.second);
 	}
 }
 
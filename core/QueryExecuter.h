@@ -3,6 +3,7 @@
 #include "ProbabilityHandler.h"
 #include "Interventions.h"
 #include "NetworkController.h"
+#include "Profiling.h"
 
 class QueryExecuter{
 
@@ -40,6 +41,18 @@ class QueryExecuter{
 	 */
 	std::pair<float,std::vector<std::string>> execute();
 
+	/**QueryExecuter
+	 *
+	 * @param stats, statistics of the query, overwritten by this call
+	 *
+	 * @return the same pair as execute()
+	 *
+	 * Executes the query while collecting counters and timers of the
+	 * inference. Apart from the total time, they are only recorded if built
+	 * with CAUSALTRAIL_PROFILING.
+	 */
+	std::pair<float,std::vector<std::string>> execute(QueryStats& stats);
+
 	/**
 	 * Stores a pair of nodeID and value reflecting a nonIntervention
 	 *
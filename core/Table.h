@@ -0,0 +1,174 @@
+#ifndef TABLE_H
+#define TABLE_H
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+
+/**
+ * Compact dense table used to store the CPTs, observation counts and dynamic
+ * programming results of the nodes. In contrast to Matrix, no row or column
+ * names are stored. The data is kept in a single flat array, columns are
+ * contiguous within a row, i.e. entry (col, row) is located at
+ * col + row * getColCount().
+ */
+template <typename T> class Table
+{
+	public:
+	/**Table
+	 *
+	 * @param colCount Number of columns
+	 * @param rowCount Number of rows
+	 * @param initialValue Initial value for all entries of the table
+	 *
+	 * @return A Table object
+	 */
+	Table(unsigned int colCount = 0, unsigned int rowCount = 0,
+	      T initialValue = T());
+
+	/**operator()
+	 *
+	 * @param col Column number
+	 * @param row Row number
+	 *
+	 * @return Value at position [col,row]. The position is not checked.
+	 */
+	T& operator()(unsigned int col, unsigned int row);
+
+	/**operator()
+	 *
+	 * @param col Column number
+	 * @param row Row number
+	 *
+	 * @return Value at position [col,row]. The position is not checked.
+	 */
+	const T& operator()(unsigned int col, unsigned int row) const;
+
+	/**setData
+	 *
+	 * @param value Value to be stored
+	 * @param col Destination column
+	 * @param row Destination row
+	 *
+	 * @throw invalid_argument if the position is not inside the table
+	 */
+	void setData(T value, unsigned int col, unsigned int row);
+
+	/**assign
+	 *
+	 * @param colCount Number of columns
+	 * @param rowCount Number of rows
+	 * @param value Value for all entries of the table
+	 *
+	 * Resizes the table and sets all entries to value, reusing the allocated memory
+	 */
+	void assign(unsigned int colCount, unsigned int rowCount, T value);
+
+	/**fill
+	 *
+	 * @param value Value for all entries of the table
+	 */
+	void fill(T value);
+
+	/**calculateRowSum
+	 *
+	 * @param row Row number
+	 *
+	 * @return The sum of all entries in the given row
+	 */
+	T calculateRowSum(unsigned int row) const;
+
+	/**getColCount
+	 *
+	 * @return Number of columns
+	 */
+	unsigned int getColCount() const;
+
+	/**getRowCount
+	 *
+	 * @return Number of rows
+	 */
+	unsigned int getRowCount() const;
+
+	/**getData
+	 *
+	 * @return Pointer to the first entry of the flat data array
+	 */
+	const T* getData() const;
+
+	private:
+	// Number of columns
+	unsigned int colCount_;
+	// Number of rows
+	unsigned int rowCount_;
+	// Entries of the table, stored row by row
+	std::vector<T> data_;
+};
+
+template <typename T>
+Table<T>::Table(unsigned int colCount, unsigned int rowCount, T initialValue)
+    : colCount_(colCount),
+      rowCount_(rowCount),
+      data_(static_cast<size_t>(colCount) * rowCount, initialValue)
+{
+}
+
+template <typename T>
+T& Table<T>::operator()(unsigned int col, unsigned int row)
+{
+	return data_[col + static_cast<size_t>(row) * colCount_];
+}
+
+template <typename T>
+const T& Table<T>::operator()(unsigned int col, unsigned int row) const
+{
+	return data_[col + static_cast<size_t>(row) * colCount_];
+}
+
+template <typename T>
+void Table<T>::setData(T value, unsigned int col, unsigned int row)
+{
+	if(col >= colCount_ || row >= rowCount_) {
+		throw std::invalid_argument("In setData, Invalid table position");
+	}
+	data_[col + static_cast<size_t>(row) * colCount_] = value;
+}
+
+template <typename T>
+void Table<T>::assign(unsigned int colCount, unsigned int rowCount, T value)
+{
+	colCount_ = colCount;
+	rowCount_ = rowCount;
+	data_.assign(static_cast<size_t>(colCount) * rowCount, value);
+}
+
+template <typename T> void Table<T>::fill(T value)
+{
+	data_.assign(data_.size(), value);
+}
+
+template <typename T> T Table<T>::calculateRowSum(unsigned int row) const
+{
+	T sum = T();
+	const T* begin = data_.data() + static_cast<size_t>(row) * colCount_;
+	for(unsigned int col = 0; col < colCount_; col++) {
+		sum += begin[col];
+	}
+	return sum;
+}
+
+template <typename T> unsigned int Table<T>::getColCount() const
+{
+	return colCount_;
+}
+
+template <typename T> unsigned int Table<T>::getRowCount() const
+{
+	return rowCount_;
+}
+
+template <typename T> const T* Table<T>::getData() const
+{
+	return data_.data();
+}
+
+#endif
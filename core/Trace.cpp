@@ -0,0 +1,101 @@
+#include "Trace.h"
+
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <stdexcept>
+
+namespace
+{
+std::mutex eventMutex;
+std::vector<Trace::Event> events;
+std::chrono::steady_clock::time_point origin;
+std::atomic<unsigned int> threadCounter{0};
+
+unsigned int threadIdentifier()
+{
+	thread_local const unsigned int id = threadCounter++;
+	return id;
+}
+
+double toMicroSeconds(std::chrono::steady_clock::duration d)
+{
+	return std::chrono::duration<double, std::micro>(d).count();
+}
+
+void writeEscaped(std::ostream& os, const char* name)
+{
+	for(const char* c = name; *c; ++c) {
+		if(*c == '"' || *c == '\\') {
+			os << '\\';
+		}
+		os << *c;
+	}
+}
+}
+
+namespace Trace
+{
+namespace detail
+{
+std::atomic<bool> enabled{false};
+}
+
+void enable()
+{
+	std::lock_guard<std::mutex> lock(eventMutex);
+	events.clear();
+	origin = std::chrono::steady_clock::now();
+	detail::enabled.store(true, std::memory_order_relaxed);
+}
+
+void disable() { detail::enabled.store(false, std::memory_order_relaxed); }
+
+std::vector<Event> getEvents()
+{
+	std::lock_guard<std::mutex> lock(eventMutex);
+	return events;
+}
+
+void write(std::ostream& os)
+{
+	std::lock_guard<std::mutex> lock(eventMutex);
+	const std::ios_base::fmtflags flags = os.flags();
+	const std::streamsize precision = os.precision();
+	os << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+	for(size_t i = 0; i < events.size(); i++) {
+		const Event& e = events[i];
+		os << (i == 0 ? "\n" : ",\n") << "{\"name\":\"";
+		writeEscaped(os, e.name);
+		os << "\",\"cat\":\"CausalTrail\",\"ph\":\"X\",\"ts\":" << e.start
+		   << ",\"dur\":" << e.duration << ",\"pid\":1,\"tid\":" << e.thread
+		   << "}";
+	}
+	os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	os.flags(flags);
+	os.precision(precision);
+}
+
+void writeFile(const std::string& filename)
+{
+	std::ofstream file(filename);
+	if(!file) {
+		throw std::invalid_argument("Could not open trace file " + filename);
+	}
+	write(file);
+}
+
+void ScopedEvent::record(const char* name,
+                         std::chrono::steady_clock::time_point start,
+                         std::chrono::steady_clock::time_point end)
+{
+	const unsigned int thread = threadIdentifier();
+	std::lock_guard<std::mutex> lock(eventMutex);
+	// Events of a previous session that ended after tracing was re-enabled
+	if(start < origin) {
+		return;
+	}
+	events.push_back(
+	    {name, toMicroSeconds(start - origin), toMicroSeconds(end - start), thread});
+}
+}
@@ -0,0 +1,115 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+/**
+ * Timeline of the training and the queries, written in the Chrome trace
+ * event format such that it can be opened in chrome://tracing or Perfetto.
+ * Events are only recorded while tracing is enabled, otherwise a scoped
+ * event costs a single relaxed atomic load.
+ */
+namespace Trace
+{
+/**
+ * A complete event, i.e. a named interval on a thread.
+ */
+struct Event {
+	// Name of the event, has to be a string literal
+	const char* name;
+	// Start in microseconds since tracing was enabled
+	double start;
+	// Duration in microseconds
+	double duration;
+	// Small identifier of the recording thread
+	unsigned int thread;
+};
+
+namespace detail
+{
+extern std::atomic<bool> enabled;
+}
+
+/**isEnabled
+ *
+ * @return true if events are currently recorded
+ */
+inline bool isEnabled()
+{
+	return detail::enabled.load(std::memory_order_relaxed);
+}
+
+/**enable
+ *
+ * Discards all recorded events and starts recording.
+ */
+void enable();
+
+/**disable
+ *
+ * Stops recording, the recorded events are kept.
+ */
+void disable();
+
+/**getEvents
+ *
+ * @return a copy of all recorded events
+ */
+std::vector<Event> getEvents();
+
+/**write
+ *
+ * @param os, stream the recorded events are written to as Chrome trace JSON
+ */
+void write(std::ostream& os);
+
+/**writeFile
+ *
+ * @param filename, file the recorded events are written to as Chrome trace JSON
+ *
+ * @throw invalid_argument if the file can not be opened
+ */
+void writeFile(const std::string& filename);
+
+/**
+ * Records an event spanning the lifetime of this object.
+ */
+class ScopedEvent
+{
+	public:
+	explicit ScopedEvent(const char* name)
+	    : name_(isEnabled() ? name : nullptr)
+	{
+		if(name_) {
+			start_ = std::chrono::steady_clock::now();
+		}
+	}
+
+	~ScopedEvent()
+	{
+		if(name_) {
+			record(name_, start_, std::chrono::steady_clock::now());
+		}
+	}
+
+	ScopedEvent(const ScopedEvent&) = delete;
+	ScopedEvent& operator=(const ScopedEvent&) = delete;
+
+	private:
+	static void record(const char* name,
+	                   std::chrono::steady_clock::time_point start,
+	                   std::chrono::steady_clock::time_point end);
+
+	const char* name_;
+	std::chrono::steady_clock::time_point start_;
+};
+}
+
+#define CT_TRACE_SCOPE(name) Trace::ScopedEvent ctTraceEvent_(name)
+
+#endif
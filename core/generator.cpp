@@ -0,0 +1,69 @@
+#include "NetworkGenerator.h"
+
+#include <iostream>
+#include <map>
+#include <stdexcept>
+
+namespace {
+void printUsage(const char* program)
+{
+	std::cout
+	    << "Usage:\n\t" << program << " [options] output_prefix\n\n"
+	    << "Writes output_prefix.tgf, output_prefix.txt and output_prefix.json\n\n"
+	    << "Options:\n"
+	    << "\t--nodes N            number of nodes (default 100)\n"
+	    << "\t--max-parents N      maximal in-degree (default 3)\n"
+	    << "\t--min-cardinality N  minimal number of values (default 2)\n"
+	    << "\t--max-cardinality N  maximal number of values (default 3)\n"
+	    << "\t--treewidth N        parents are chosen among the N preceding\n"
+	    << "\t                     nodes, 0 for no bound (default 0)\n"
+	    << "\t--samples N          number of samples (default 1000)\n"
+	    << "\t--na-rate R          fraction of missing values (default 0)\n"
+	    << "\t--seed N             random seed (default 42)\n";
+}
+}
+
+int main(int argc, char* argv[])
+{
+	GeneratorSettings settings;
+	unsigned int samples = 1000;
+	float naRate = 0.0f;
+	std::map<std::string, unsigned int*> unsignedOptions = {
+	    {"--nodes", &settings.nodes},
+	    {"--max-parents", &settings.maxParents},
+	    {"--min-cardinality", &settings.minCardinality},
+	    {"--max-cardinality", &settings.maxCardinality},
+	    {"--treewidth", &settings.treewidth},
+	    {"--samples", &samples},
+	    {"--seed", &settings.seed}};
+
+	std::string prefix;
+	try {
+		for(int i = 1; i < argc; i++) {
+			const std::string argument = argv[i];
+			auto option = unsignedOptions.find(argument);
+			if(option != unsignedOptions.end() && i + 1 < argc) {
+				*option->second = std::stoul(argv[++i]);
+			} else if(argument == "--na-rate" && i + 1 < argc) {
+				naRate = std::stof(argv[++i]);
+			} else if(argument.compare(0, 2, "--") != 0 && prefix.empty()) {
+				prefix = argument;
+			} else {
+				throw std::invalid_argument("Unknown argument '" + argument + "'");
+			}
+		}
+		if(prefix.empty()) {
+			throw std::invalid_argument("No output prefix specified");
+		}
+
+		NetworkGenerator generator(settings);
+		generator.writeNetwork(prefix + ".tgf");
+		generator.writeObservations(prefix + ".txt", samples, naRate);
+		generator.writeDiscretisation(prefix + ".json");
+	} catch(std::exception& e) {
+		std::cerr << e.what() << "\n\n";
+		printUsage(argv[0]);
+		return -1;
+	}
+	return 0;
+}
@@ -1,39 +1,151 @@
 #include "NetworkController.h"
 #include "Parser.h"
+#include "Trace.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+void printEMStats(const std::vector<EMIterationStats>& iterations)
+{
+	if(iterations.empty()) {
+		return;
+	}
+	std::chrono::nanoseconds total{0};
+	for(const auto& iteration : iterations) {
+		total += iteration.time;
+	}
+	std::cout << "EM iterations profiled: " << iterations.size()
+	          << "\nMean time per iteration: "
+	          << std::chrono::duration<double, std::micro>(total).count() /
+	                 iterations.size()
+	          << "µs\nFinal parameter difference: "
+	          << iterations.back().difference << std::endl;
+}
+
+void printUsage(const char* program)
+{
+	std::cout
+	    << "Usage:\n\t" << program
+	    << " [options] observations.txt discretisation_control.json "
+	       "network.tgf\n\n"
+	    << "or:\n\t" << program
+	    << " [options] observations.txt discretisation_control.json "
+	       "network.dot\n\n"
+	    << "or:\n\t" << program
+	    << " [options] observations.txt discretisation_control.json "
+	       "network.sif network.na\n\n"
+	    << "Options:\n"
+	    << "\t--profile                 print training and query statistics\n"
+	    << "\t--trace FILE              write a Chrome trace of the run to FILE\n"
+	    << "\t--stream N                train without loading the observations,\n"
+	    << "\t                          reading N samples at a time\n"
+	    << "\t--restarts N              number of random EM initialisations\n"
+	    << "\t--squarem                 accelerate EM by SQUAREM extrapolation\n"
+	    << "\t--likelihood-threshold T  stop EM once the relative "
+	       "log-likelihood change is below T\n";
+}
+
+// Parses the whole value of an option, which has to be a finite number that
+// is not negative
+template <typename T>
+T parseOptionValue(const std::string& option, const char* value)
+{
+	T result = 0;
+	const char* last = value + std::strlen(value);
+	auto res = std::from_chars(value, last, result);
+	if(res.ec != std::errc() || res.ptr != last ||
+	   std::signbit(static_cast<double>(result)) ||
+	   !std::isfinite(static_cast<double>(result))) {
+		throw std::invalid_argument("Invalid value '" + std::string(value) +
+		                            "' for " + option);
+	}
+	return result;
+}
+}
 
 int main(int argc, char* argv[])
 {
 	NetworkController c;
-	if(argc < 4) {
-		std::cout
-		    << "Insufficient number of parameters\n\n"
-		    << "Usage:\n\t" << argv[0]
-		    << " observations.txt discretisation_control.json network.tgf\n\n"
-		    << "or:\n\t" << argv[0]
-		    << " observations.txt discretisation_control.json network.sif "
-		       "network.na\n";
-
+	bool profile = false;
+	std::string traceFile;
+	unsigned int chunkSize = 0;
+	std::vector<std::string> args;
+	try {
+		for(int i = 0; i < argc; i++) {
+			const std::string arg(argv[i]);
+			if(arg == "--profile") {
+				profile = true;
+			} else if(arg == "--trace" && i + 1 < argc) {
+				traceFile = argv[++i];
+			} else if(arg == "--stream" && i + 1 < argc) {
+				chunkSize = parseOptionValue<unsigned int>(arg, argv[++i]);
+				if(chunkSize == 0) {
+					throw std::invalid_argument(
+					    "The number of samples for --stream has to be positive");
+				}
+			} else if(arg == "--restarts" && i + 1 < argc) {
+				EMSettings settings = c.getEMSettings();
+				settings.randomRestarts =
+				    parseOptionValue<unsigned int>(arg, argv[++i]);
+				c.setEMSettings(settings);
+			} else if(arg == "--squarem") {
+				EMSettings settings = c.getEMSettings();
+				settings.acceleration = EMAcceleration::SQUAREM;
+				c.setEMSettings(settings);
+			} else if(arg == "--likelihood-threshold" && i + 1 < argc) {
+				EMSettings settings = c.getEMSettings();
+				settings.convergence = EMConvergence::LogLikelihood;
+				settings.likelihoodThreshold =
+				    parseOptionValue<double>(arg, argv[++i]);
+				c.setEMSettings(settings);
+			} else {
+				args.emplace_back(argv[i]);
+			}
+		}
+	} catch(std::invalid_argument& e) {
+		std::cout << e.what() << "\n\n";
+		printUsage(argv[0]);
+		return -1;
+	}
+	if(args.size() < 4) {
+		std::cout << "Insufficient number of parameters\n\n";
+		printUsage(argv[0]);
 		return -1;
 	}
 
-	std::string datafile = argv[1];
-	std::string controlfile = argv[2];
-	std::string networkfile = argv[3];
+	if(!traceFile.empty()) {
+		Trace::enable();
+	}
 
-	if(argc == 5) {
-		std::string nodefile = argv[4];
-		c.loadNetwork(nodefile);
+	const std::string& datafile = args[1];
+	const std::string& controlfile = args[2];
+	const std::string& networkfile = args[3];
+
+	if(args.size() == 5) {
+		c.loadNetwork(args[4]);
 	}
 
 	c.loadNetwork(networkfile);
-	c.loadObservations(datafile, controlfile);
-	c.trainNetwork();
+	if(chunkSize > 0) {
+		c.trainNetworkFromFile(datafile, controlfile, chunkSize);
+	} else {
+		c.loadObservations(datafile, controlfile);
+		c.trainNetwork();
+	}
 
 	std::cout << c.getNetwork()
 	          << "\nNumber of EM runs: " << c.getNumberOfEMRuns()
 	          << "\nTime used for training: " << c.getTimeInMicroSeconds()
 	          << "µs" << std::endl;
+	if(profile) {
+		printEMStats(c.getEMIterationStats());
+	}
 
 	std::string input = "";
 	std::cout << "Please enter a query" << std::endl;
@@ -44,11 +156,15 @@ int main(int argc, char* argv[])
 			Parser p3 = Parser(input, c);
 			QueryExecuter qe3 = p3.parseQuery();
 
-			auto result = qe3.execute();
+			QueryStats stats;
+			auto result = profile ? qe3.execute(stats) : qe3.execute();
 			std::cout << result.first << std::endl;
 			for(const auto& arg : result.second) {
 				std::cout << arg << "\n";
 			}
+			if(profile) {
+				std::cout << stats;
+			}
 			std::cout << std::endl;
 		} catch(std::exception& e) {
 			std::cerr << e.what() << std::endl;
@@ -58,5 +174,10 @@ int main(int argc, char* argv[])
 		std::getline(std::cin, input);
 	}
 
+	if(!traceFile.empty()) {
+		Trace::disable();
+		Trace::writeFile(traceFile);
+	}
+
 	return 0;
 }
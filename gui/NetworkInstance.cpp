@@ -113,14 +113,14 @@ float NetworkInstance::getProbabilityAt(unsigned int row, unsigned int col)
     return nc_.getNetwork().getNode(selectedNode_).getProbabilityMatrix()(col,row);
 }
 
-const std::vector<std::string> &NetworkInstance::getRowNamesOfProbabilityMatrix()
+std::vector<std::string> NetworkInstance::getRowNamesOfProbabilityMatrix()
 {
-   return nc_.getNetwork().getNode(selectedNode_).getProbabilityMatrix().getRowNames();
+   return nc_.getNetwork().getNode(selectedNode_).getParentValueNames();
 }
 
 const std::vector<std::string> &NetworkInstance::getColNamesOfProbabilityMatrix()
 {
-   return nc_.getNetwork().getNode(selectedNode_).getProbabilityMatrix().getColNames();
+   return nc_.getNetwork().getNode(selectedNode_).getValueNamesProb();
 }
 
 void NetworkInstance::visualizeNonInterventionNodes(std::vector<QString> &nonInterventions)
@@ -224,7 +224,7 @@ class NetworkInstance : public QWidget {
      * @brief getRowNamesOfProbabilityMatrix
      * @return Reference to a vector containing the row names of the probability matrix of the currently selected node
      */
-    const std::vector<std::string>& getRowNamesOfProbabilityMatrix();
+    std::vector<std::string> getRowNamesOfProbabilityMatrix();
 
     /**
      * @brief getColNamesOfProbabilityMatrix
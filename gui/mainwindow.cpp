@@ -203,7 +203,7 @@ ui->tabWidget->removeTab(ui->tabWidget->currentIndex());
 void MainWindow::on_actionLoadNetwork_triggered()
 {
 	QString filename = QFileDialog::getOpenFileName(
-	    this, tr("Load network file"), config_->dataDir(), "*.tgf *.na");
+	    this, tr("Load network file"), config_->dataDir(), "*.tgf *.na *.dot *.gv");
 
 	if(filename == "") {
 		addLogMessage("No file containing network data specified.");
@@ -0,0 +1,51 @@
+#include "gtest/gtest.h"
+#include "../core/AdjacencyList.h"
+
+class AdjacencyListTest : public ::testing::Test{
+	protected:
+	AdjacencyListTest()
+		:a_(4)
+	{
+	}
+
+	void virtual SetUp(){
+		a_.addEdges({{2,0},{2,1},{3,2},{2,0}});
+	}
+
+	public:
+	AdjacencyList a_;
+};
+
+TEST_F(AdjacencyListTest, bulkBuild){
+	ASSERT_EQ(4u, a_.size());
+	ASSERT_EQ(3u, a_.getEdgeCount());
+	std::vector<unsigned int> parents(a_.getParents(2).begin(), a_.getParents(2).end());
+	ASSERT_EQ(std::vector<unsigned int>({0,1}), parents);
+	std::vector<unsigned int> children(a_.getChildren(2).begin(), a_.getChildren(2).end());
+	ASSERT_EQ(std::vector<unsigned int>({3}), children);
+	ASSERT_TRUE(a_.getParents(0).empty());
+	ASSERT_TRUE(a_.getParents(42).empty());
+}
+
+TEST_F(AdjacencyListTest, addRemoveEdge){
+	a_.addEdge(3,0);
+	a_.addEdge(3,0);
+	ASSERT_EQ(4u, a_.getEdgeCount());
+	ASSERT_TRUE(a_.hasEdge(3,0));
+	std::vector<unsigned int> parents(a_.getParents(3).begin(), a_.getParents(3).end());
+	ASSERT_EQ(std::vector<unsigned int>({0,2}), parents);
+	ASSERT_EQ(2u, a_.getChildren(0).size());
+	a_.removeEdge(2,0);
+	ASSERT_FALSE(a_.hasEdge(2,0));
+	ASSERT_EQ(1u, a_.getParents(2).size());
+	ASSERT_EQ(1u, a_.getChildren(0).size());
+	ASSERT_EQ(3u, a_.getChildren(0)[0]);
+	ASSERT_THROW(a_.addEdge(4,0), std::invalid_argument);
+}
+
+TEST_F(AdjacencyListTest, addEdgesKeepsExisting){
+	a_.addEdges({{1,0}});
+	ASSERT_EQ(4u, a_.getEdgeCount());
+	ASSERT_TRUE(a_.hasEdge(1,0));
+	ASSERT_TRUE(a_.hasEdge(3,2));
+}
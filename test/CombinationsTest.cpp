@@ -26,39 +26,68 @@ class CombinationsTest : public ::testing::Test{
 };
 
 TEST_F(CombinationsTest,Int){
-	Combinations<int> c(keys,mapInt);
-	c.createCombinations();
-	std::vector<std::vector<int>> result = c.getResult();
-	ASSERT_EQ(6u, result.size());
-	ASSERT_EQ(1,result[0][0]);
-	ASSERT_EQ(1,result[0][1]);
-	ASSERT_EQ(1,result[1][0]);
-	ASSERT_EQ(2,result[1][1]);
-	ASSERT_EQ(1,result[2][0]);
-	ASSERT_EQ(3,result[2][1]);
-	ASSERT_EQ(2,result[3][0]);
-	ASSERT_EQ(1,result[3][1]);
-	ASSERT_EQ(2,result[4][0]);
-	ASSERT_EQ(2,result[4][1]);
-	ASSERT_EQ(2,result[5][0]);
-	ASSERT_EQ(3,result[5][1]);
+	std::vector<int> assignment(2,0);
+	CombinationCounter<int> counter(keys,mapInt,assignment);
+	ASSERT_EQ(6u, counter.size());
+	ASSERT_FALSE(counter.empty());
+	std::vector<std::vector<int>> result;
+	do {
+		result.push_back(assignment);
+	} while(counter.next());
+	std::vector<std::vector<int>> expected =
+		{{1,1},{1,2},{1,3},{2,1},{2,2},{2,3}};
+	ASSERT_EQ(expected, result);
+	//The counter wraps around to the first assignment
+	ASSERT_EQ(1,assignment[0]);
+	ASSERT_EQ(1,assignment[1]);
 }
 
 TEST_F(CombinationsTest,String){
-	Combinations<std::string> c(keys,mapString);
-	c.createCombinations();
-	std::vector<std::vector<std::string>> result = c.getResult();
-	ASSERT_EQ(6u, result.size());
-	ASSERT_EQ("A",result[0][0]);
-	ASSERT_EQ("A",result[0][1]);
-	ASSERT_EQ("A",result[1][0]);
-	ASSERT_EQ("B",result[1][1]);
-	ASSERT_EQ("A",result[2][0]);
-	ASSERT_EQ("C",result[2][1]);
-	ASSERT_EQ("B",result[3][0]);
-	ASSERT_EQ("A",result[3][1]);
-	ASSERT_EQ("B",result[4][0]);
-	ASSERT_EQ("B",result[4][1]);
-	ASSERT_EQ("B",result[5][0]);
-	ASSERT_EQ("C",result[5][1]);
+	std::vector<std::string> assignment(2);
+	CombinationCounter<std::string> counter(keys,mapString,assignment);
+	ASSERT_EQ(6u, counter.size());
+	std::vector<std::vector<std::string>> result;
+	do {
+		result.push_back(assignment);
+	} while(counter.next());
+	std::vector<std::vector<std::string>> expected =
+		{{"A","A"},{"A","B"},{"A","C"},{"B","A"},{"B","B"},{"B","C"}};
+	ASSERT_EQ(expected, result);
+}
+
+TEST_F(CombinationsTest,SubsetOfKeys){
+	std::vector<unsigned int> subset = {1};
+	std::vector<int> assignment(2,0);
+	CombinationCounter<int> counter(subset,mapInt,assignment);
+	ASSERT_EQ(3u, counter.size());
+	std::vector<int> result;
+	do {
+		//Keys outside of the subset are left untouched
+		ASSERT_EQ(0,assignment[0]);
+		result.push_back(assignment[1]);
+	} while(counter.next());
+	ASSERT_EQ(valuesInt2, result);
+}
+
+TEST_F(CombinationsTest,Empty){
+	mapInt[1].clear();
+	std::vector<int> assignment(2,0);
+	CombinationCounter<int> counter(keys,mapInt,assignment);
+	ASSERT_TRUE(counter.empty());
+	ASSERT_EQ(0u, counter.size());
+}
+
+TEST_F(CombinationsTest,CounterDigits){
+	std::vector<std::string> assignment(2);
+	CombinationCounter<std::string> counter(keys,mapString,assignment);
+	counter.next();
+	counter.next();
+	std::vector<unsigned int> digits = counter.getDigits();
+	ASSERT_EQ("C",assignment[1]);
+	counter.next();
+	ASSERT_EQ("B",assignment[0]);
+	ASSERT_EQ("A",assignment[1]);
+	counter.setDigits(digits);
+	ASSERT_EQ("A",assignment[0]);
+	ASSERT_EQ("C",assignment[1]);
 }
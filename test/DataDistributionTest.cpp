@@ -103,6 +103,30 @@ TEST_F(DataDistributionTest, assignObservationsToNodesTestStudentComplet){
 	ASSERT_TRUE(parentValueNamess == sat.getParentValueNames());
 }
 
+TEST_F(DataDistributionTest, parentValueTableStudent){
+	Network n;
+	n.readNetwork(TEST_DATA_PATH("Student.na"));
+	n.readNetwork(TEST_DATA_PATH("Student.sif"));
+	Matrix<std::string> originalObservations (TEST_DATA_PATH("StudentData.txt"),false,true);
+	Matrix<int> observations (0,0,-1);
+	Discretiser disc(originalObservations,TEST_DATA_PATH("controlStudent.json"), observations, n);
+	DataDistribution db (n, observations);
+	db.assignObservationsToNodes();
+
+	Node& intel = n.getNode("Intelligence");
+	ASSERT_TRUE(intel.getParentValues().empty());
+
+	Node& grade = n.getNode("Grade");
+	std::vector<Node::ParentValue> parentValuesg {0,0, 0,1, 1,0, 1,1};
+	ASSERT_TRUE(parentValuesg == grade.getParentValues());
+	ASSERT_EQ(1u, grade.getParentValue(2,0));
+	ASSERT_EQ(0u, grade.getParentValue(2,1));
+
+	Node& letter = n.getNode("Letter");
+	std::vector<Node::ParentValue> parentValuesl {0,1,2};
+	ASSERT_TRUE(parentValuesl == letter.getParentValues());
+}
+
 TEST_F(DataDistributionTest, assignObservationsToNodesTestStudentInComplet){
 	Network n;
 	n.readNetwork(TEST_DATA_PATH("Student.na"));
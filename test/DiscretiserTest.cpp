@@ -2,6 +2,9 @@
 #include "../core/Discretiser.h"
 #include "config.h"
 
+#include <algorithm>
+#include <cmath>
+
 class DiscretiserTest : public ::testing::Test{
 	protected:
 	DiscretiserTest()
@@ -299,3 +302,62 @@ TEST_F(DiscretiserTest, ZIncludingNA){
 	ASSERT_EQ(0,dObs(4,10));
 	ASSERT_EQ(-1,dObs(5,10));
 }
+
+TEST_F(DiscretiserTest,CodesSameAsMatrix){
+	for(const char* file : {"testObservations.txt", "testObservationsIncludingNA.txt"}) {
+		SCOPED_TRACE(file);
+		Matrix<std::string> oriObs (TEST_DATA_PATH("") + std::string(file),false,true);
+		Matrix<int> dObs;
+		Network matrixNetwork;
+		Discretiser d (oriObs,TEST_DATA_PATH("jsonDiscretiserTest.json"),dObs,matrixNetwork);
+		ObservationCodes codes;
+		Network codesNetwork;
+		Discretiser c (Matrix<std::string>(oriObs),TEST_DATA_PATH("jsonDiscretiserTest.json"),codes,codesNetwork);
+		ASSERT_EQ(dObs.getRowNames(), codes.getRowNames());
+		ASSERT_EQ(dObs.getColNames(), codes.getColNames());
+		ASSERT_EQ(ObservationCodes(dObs).getWidth(), codes.getWidth());
+		for(unsigned int row = 0; row < dObs.getRowCount(); row++) {
+			for(unsigned int col = 0; col < dObs.getColCount(); col++) {
+				ASSERT_EQ(dObs(col, row), codes(col, row));
+			}
+		}
+		ASSERT_EQ(matrixNetwork.getObservationsMap(), codesNetwork.getObservationsMap());
+		ASSERT_EQ(matrixNetwork.getObservationsMapR(), codesNetwork.getObservationsMapR());
+	}
+}
+
+TEST_F(DiscretiserTest,ParseRow){
+	Matrix<std::string> oriObs (4, 1, "NA");
+	oriObs(0, 0) = "1.5";
+	oriObs(2, 0) = "+2";
+	oriObs(3, 0) = " -3e1";
+	const auto numbers = Discretisations::parseRow(oriObs, 0);
+	ASSERT_EQ(4, numbers.size());
+	ASSERT_FALSE(numbers.isNA(0));
+	ASSERT_TRUE(numbers.isNA(1));
+	ASSERT_FLOAT_EQ(1.5f, numbers.values[0]);
+	ASSERT_FLOAT_EQ(2.0f, numbers.values[2]);
+	ASSERT_FLOAT_EQ(-30.0f, numbers.values[3]);
+}
+
+TEST_F(DiscretiserTest,SelectOrderStatistics){
+	std::vector<float> values = {5, 3, 9, 1, 7, 3, 8, 2, 6, 0};
+	std::vector<float> sorted(values);
+	std::sort(sorted.begin(), sorted.end());
+	const std::vector<size_t> ranks = {9, 0, 4, 4, 5, 2, 10};
+	const auto selected = Discretisations::selectOrderStatistics(values, ranks);
+	ASSERT_EQ(ranks.size(), selected.size());
+	for(size_t i = 0; i + 1 < ranks.size(); i++) {
+		ASSERT_EQ(sorted[ranks[i]], selected[i]);
+	}
+	ASSERT_TRUE(std::isnan(selected.back()));
+}
+
+TEST_F(DiscretiserTest,FindBucket){
+	const std::vector<float> borders = {0.0f, 1.0f, 1.0f, 2.0f};
+	ASSERT_EQ(Discretisations::NA, Discretisations::findBucket(borders, -1.0f));
+	ASSERT_EQ(0, Discretisations::findBucket(borders, 0.0f));
+	ASSERT_EQ(0, Discretisations::findBucket(borders, 0.5f));
+	ASSERT_EQ(2, Discretisations::findBucket(borders, 1.0f));
+	ASSERT_EQ(Discretisations::NA, Discretisations::findBucket(borders, 2.0f));
+}
@@ -130,4 +130,32 @@ TEST_F(DotReaderTest, edgeList) {
 	assertHasAttribute(graph.edges[0].attributes, "color", "red");
 	assertHasAttribute(graph.edges[1].attributes, "color", "red");
 	assertHasAttribute(graph.edges[2].attributes, "color", "red");
-}
\ No newline at end of file
+}
+TEST_F(DotReaderTest, parseStructure) {
+	const std::string file =
+		"strict digraph G {\n"
+		"\trankdir=LR\n"
+		"\tnode [shape=box]\n"
+		"\t\"first node\" [label=\"A\"];\n"
+		"\ta:ne -> b:p:s -> c [color=blue]\n"
+		"\tc -> \"first node\";\n"
+		"}\n";
+	bool isDirected = false;
+	std::vector<std::string> nodes;
+	std::vector<std::pair<std::string, std::string>> edges;
+	ASSERT_TRUE(Dot::Reader::parseStructure(file.data(), file.data() + file.size(), isDirected,
+		[&nodes](std::string_view node) { nodes.emplace_back(node); },
+		[&edges](std::string_view source, std::string_view target) {
+			edges.emplace_back(source, target);
+		}));
+	EXPECT_TRUE(isDirected);
+	EXPECT_EQ(std::vector<std::string>{"first node"}, nodes);
+	std::vector<std::pair<std::string, std::string>> expectedEdges = {
+		{"a", "b"}, {"b", "c"}, {"c", "first node"}};
+	EXPECT_EQ(expectedEdges, edges);
+
+	const std::string undirected = readFile(TEST_DATA_PATH("simpleGraph.dot"));
+	ASSERT_TRUE(Dot::Reader::parseStructure(undirected.data(), undirected.data() + undirected.size(),
+		isDirected, [](std::string_view) {}, [](std::string_view, std::string_view) {}));
+	EXPECT_FALSE(isDirected);
+}
@@ -2,6 +2,7 @@
 #include "../core/NetworkController.h"
 #include "../core/EM.h"
 #include "config.h"
+#include "NetworkAssertions.h"
 
 class EMTest : public ::testing::Test{
 	protected:
@@ -94,3 +95,124 @@ TEST_F(EMTest,UnComplete){
 	ASSERT_NEAR(0.2f,sat.getProbability(0,1),0.2);
 	ASSERT_NEAR(0.8f,sat.getProbability(1,1),0.2);
 }
+
+TEST_F(EMTest,RandomRestarts){
+	c.loadNetwork(TEST_DATA_PATH("Student.na"));
+	c.loadNetwork(TEST_DATA_PATH("Student.sif"));
+	c.loadObservations(TEST_DATA_PATH("dataStudent60.txt"),TEST_DATA_PATH("controlStudent.json"));
+	c.trainNetwork();
+	float likelihood = c.getLikelihoodOfTheData();
+
+	EMSettings settings = c.getEMSettings();
+	settings.randomRestarts = 4;
+	settings.threads = 3;
+	c.setEMSettings(settings);
+	c.trainNetwork();
+	ASSERT_GE(c.getLikelihoodOfTheData(), likelihood);
+	for(const Node& n : c.getNetwork().getNodes()) {
+		const Table<float>& p = n.getProbabilityMatrix();
+		for(unsigned int row = 0; row < p.getRowCount(); row++) {
+			ASSERT_NEAR(1.0f, p.calculateRowSum(row), 0.001);
+		}
+	}
+}
+
+TEST_F(EMTest,RestartsAreDeterministic){
+	NetworkController other;
+	EMSettings settings = c.getEMSettings();
+	settings.randomRestarts = 3;
+	settings.threads = 1;
+	c.setEMSettings(settings);
+	settings.threads = 5;
+	other.setEMSettings(settings);
+	for(NetworkController* controller : {&c, &other}) {
+		controller->loadNetwork(TEST_DATA_PATH("Student.na"));
+		controller->loadNetwork(TEST_DATA_PATH("Student.sif"));
+		controller->loadObservations(TEST_DATA_PATH("dataStudent60.txt"),TEST_DATA_PATH("controlStudent.json"));
+		controller->trainNetwork();
+	}
+	ASSERT_EQ(c.getNumberOfEMRuns(), other.getNumberOfEMRuns());
+	expectSameParameters(c.getNetwork(), other.getNetwork(), 0.0f);
+}
+
+TEST_F(EMTest,SQUAREM){
+	NetworkController accelerated;
+	EMSettings settings = c.getEMSettings();
+	settings.convergence = EMConvergence::LogLikelihood;
+	settings.likelihoodThreshold = 1e-9;
+	c.setEMSettings(settings);
+	settings.acceleration = EMAcceleration::SQUAREM;
+	accelerated.setEMSettings(settings);
+	for(NetworkController* controller : {&c, &accelerated}) {
+		controller->loadNetwork(TEST_DATA_PATH("Student.na"));
+		controller->loadNetwork(TEST_DATA_PATH("Student.sif"));
+		controller->loadObservations(TEST_DATA_PATH("dataStudent60.txt"),TEST_DATA_PATH("controlStudent.json"));
+		controller->trainNetwork();
+	}
+	for(const Node& n : accelerated.getNetwork().getNodes()) {
+		const Table<float>& q = n.getProbabilityMatrix();
+		for(unsigned int row = 0; row < q.getRowCount(); row++) {
+			ASSERT_NEAR(1.0f, q.calculateRowSum(row), 0.001);
+		}
+	}
+	expectSameParameters(c.getNetwork(), accelerated.getNetwork(), 0.01f);
+}
+
+TEST_F(EMTest,SQUAREMNeedsFewerSteps){
+	c.loadNetwork(TEST_DATA_PATH("Student.na"));
+	c.loadNetwork(TEST_DATA_PATH("Student.sif"));
+	c.loadObservations(TEST_DATA_PATH("dataStudent60.txt"),TEST_DATA_PATH("controlStudent.json"));
+	c.trainNetwork();
+	EMSettings settings = c.getEMSettings();
+	settings.convergence = EMConvergence::LogLikelihood;
+	settings.likelihoodThreshold = 1e-9;
+	settings.randomRestarts = 1;
+	for(unsigned int initialisation : {0u, 2u}) {
+		SCOPED_TRACE(initialisation);
+		Network plainNetwork = c.getNetwork();
+		Network acceleratedNetwork = c.getNetwork();
+		settings.acceleration = EMAcceleration::None;
+		EM plain(plainNetwork, c.getObservations(), settings);
+		plain.performEM(initialisation);
+		settings.acceleration = EMAcceleration::SQUAREM;
+		EM accelerated(acceleratedNetwork, c.getObservations(), settings);
+		accelerated.performEM(initialisation);
+		ASSERT_EQ(initialisation, accelerated.getInitialisation());
+		ASSERT_LT(accelerated.getNumberOfRuns(), plain.getNumberOfRuns());
+		ASSERT_NEAR(plain.calculateLikelihoodOfTheData(), accelerated.calculateLikelihoodOfTheData(), 0.01);
+	}
+	Network network = c.getNetwork();
+	EM em(network, c.getObservations(), settings);
+	ASSERT_THROW(em.performEM(3), std::invalid_argument);
+}
+
+TEST_F(EMTest,ConvergesToObservedFrequencies){
+	// With all parents observed, the fixed point of EM are the relative
+	// frequencies of the observed values, provided the expected counts are
+	// not truncated
+	EMSettings settings = c.getEMSettings();
+	settings.differenceThreshold = 1e-7f;
+	c.setEMSettings(settings);
+	c.loadNetwork(TEST_DATA_PATH("Student.na"));
+	c.loadNetwork(TEST_DATA_PATH("Student.sif"));
+	c.loadObservations(TEST_DATA_PATH("dataStudent60.txt"),TEST_DATA_PATH("controlStudent.json"));
+	c.trainNetwork();
+	unsigned int nodesWithNA = 0;
+	for(const Node& n : c.getNetwork().getNodes()) {
+		if(!n.hasNA()) {
+			continue;
+		}
+		nodesWithNA++;
+		const Table<int>& obs = n.getObservationMatrix();
+		for(unsigned int row = 0; row < obs.getRowCount(); row++) {
+			float observed = obs.calculateRowSum(row) - obs(0, row);
+			if(observed == 0.0f) {
+				continue;
+			}
+			for(unsigned int col = 1; col < obs.getColCount(); col++) {
+				ASSERT_NEAR(obs(col, row) / observed, n.getProbability(col - 1, row), 1e-4);
+			}
+		}
+	}
+	ASSERT_GT(nodesWithNA, 0u);
+}
@@ -37,7 +37,7 @@ TEST_F(FactorTest, FactorConstructorTestDirect){
 TEST_F(FactorTest, getIDs){
 	std::vector<unsigned int> testIds = {0,1,2,3};
 	Factor f (10,testIds);
-	ASSERT_TRUE(testIds == f.getIDs());
+	ASSERT_TRUE(std::equal(testIds.begin(), testIds.end(), f.getIDs().begin(), f.getIDs().end()));
 }
 
 TEST_F(FactorTest, knownValuesGetProbability){
@@ -54,6 +54,19 @@ TEST_F(FactorTest, knownValuesGetProbability){
 	
 }
 
+TEST_F(FactorTest, knownValuesSlice){
+	Network n = c.getNetwork();
+	std::vector<int> values (5,-1);
+	values[2]=1;
+	values[n.getNode("Grade").getID()]=0;
+	Factor f (n.getNode("Grade"), values);
+	ASSERT_NEAR(0.9f, f.getProbability(0),0.001);
+	ASSERT_NEAR(0.5f, f.getProbability(1),0.001);
+	values[2]=2;
+	Factor empty (n.getNode("Grade"), values);
+	ASSERT_NEAR(1.0f, empty.getProbability(values),0.001);
+}
+
 TEST_F(FactorTest, addGetProbability){
 	std::vector<unsigned int> testIds = {0,1,2,3};
 	Factor f (10,testIds);
@@ -117,7 +130,7 @@ TEST_F(FactorTest, sumOut){
 	Factor fIntelligence (n.getNode("Intelligence"), emptyValues);
 	Factor product = fGrade.product(fIntelligence, n, emptyValues);
 	Factor sumOut = product.sumOut(n.getNode("Intelligence").getID(), n, emptyValues);
-	std::vector<unsigned int> newIDs {1,0};
+	std::pmr::vector<unsigned int> newIDs {1,0};
 	ASSERT_TRUE(newIDs == sumOut.getIDs());
 	ASSERT_NEAR(0.48f,sumOut.getProbability(0),0.001);
 	ASSERT_NEAR(0.185f,sumOut.getProbability(1),0.001);
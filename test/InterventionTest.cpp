@@ -105,19 +105,19 @@ TEST_F(InterventionTest, addEdgeProbability){
 	Interventions i(c);
 	Network& n = c.getNetwork();
 	Node& letter = n.getNode("Letter");
-	Matrix<float> prob = letter.getProbabilityMatrix();
+	Table<float> prob = letter.getProbabilityMatrix();
 	ASSERT_EQ(2u, prob.getColCount());
 	ASSERT_EQ(3u, prob.getRowCount());
 	i.createBackupOfNetworkStructure();
 	i.addEdge(3,4);
 	c.trainNetwork();
-	Matrix<float> probAdd = letter.getProbabilityMatrix();
+	Table<float> probAdd = letter.getProbabilityMatrix();
 	ASSERT_EQ(2u, probAdd.getColCount());
 	ASSERT_EQ(6u, probAdd.getRowCount());
 	i.loadBackupOfNetworkStructure();
 	i.removeEdge(3,4);
 	c.trainNetwork();
-	Matrix<float> probNew = letter.getProbabilityMatrix();
+	Table<float> probNew = letter.getProbabilityMatrix();
 	ASSERT_EQ(2u, probNew.getColCount());
 	ASSERT_EQ(3u, probNew.getRowCount());
 	i.createBackupOfNetworkStructure();
@@ -143,19 +143,19 @@ TEST_F(InterventionTest, removeEdgeProbability){
 	Interventions i(c);
 	Network& n = c.getNetwork();
 	Node& letter = n.getNode("Letter");
-	Matrix<float> prob = letter.getProbabilityMatrix();
+	Table<float> prob = letter.getProbabilityMatrix();
 	ASSERT_EQ(2u, prob.getColCount());
 	ASSERT_EQ(3u, prob.getRowCount());
 	i.createBackupOfNetworkStructure();
 	i.removeEdge("Grade","Letter");
 	c.trainNetwork();
-	Matrix<float> probAdd = letter.getProbabilityMatrix();
+	Table<float> probAdd = letter.getProbabilityMatrix();
 	ASSERT_EQ(2u, probAdd.getColCount());
 	ASSERT_EQ(1u, probAdd.getRowCount());
 	i.loadBackupOfNetworkStructure();
 	i.addEdge("Grade","Letter");
 	c.trainNetwork();
-	Matrix<float> probNew = letter.getProbabilityMatrix();
+	Table<float> probNew = letter.getProbabilityMatrix();
 	ASSERT_EQ(2u, probNew.getColCount());
 	ASSERT_EQ(3u, probNew.getRowCount());
 
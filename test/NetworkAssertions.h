@@ -0,0 +1,34 @@
+#ifndef CAT_TEST_NETWORK_ASSERTIONS_H
+#define CAT_TEST_NETWORK_ASSERTIONS_H
+
+#include "gtest/gtest.h"
+#include "../core/Network.h"
+
+/**expectSameParameters
+ *
+ * @param expected, network containing the expected CPTs
+ * @param actual, network whose nodes are compared by name
+ * @param tolerance, allowed absolute difference of a probability
+ *
+ * Checks that the CPTs of all nodes of expected have the same shape and
+ * values in actual.
+ */
+inline void expectSameParameters(const Network& expected, const Network& actual,
+                                 float tolerance)
+{
+	for(const Node& node : expected.getNodes()) {
+		SCOPED_TRACE(node.getName());
+		const Table<float>& p = node.getProbabilityMatrix();
+		const Table<float>& q = actual.getNode(node.getName()).getProbabilityMatrix();
+		ASSERT_EQ(p.getRowCount(), q.getRowCount());
+		ASSERT_EQ(p.getColCount(), q.getColCount());
+		for(unsigned int row = 0; row < p.getRowCount(); row++) {
+			for(unsigned int col = 0; col < p.getColCount(); col++) {
+				EXPECT_NEAR(p(col, row), q(col, row), tolerance)
+				    << "at value " << col << ", parent row " << row;
+			}
+		}
+	}
+}
+
+#endif
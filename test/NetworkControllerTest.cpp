@@ -1,6 +1,7 @@
 #include "gtest/gtest.h"
 #include "../core/NetworkController.h"
 #include "config.h"
+#include "NetworkAssertions.h"
 
 class NetworkControllerTest : public ::testing::Test{
 	protected:
@@ -226,3 +227,110 @@ TEST_F(NetworkControllerTest, EdgeAdditionPossibility){
 }
 
 
+
+class NetworkControllerSamplesTest : public ::testing::Test{
+	protected:
+	NetworkControllerSamplesTest()
+	{
+		c.loadNetwork(TEST_DATA_PATH("Student.na"));
+		c.loadNetwork(TEST_DATA_PATH("Student.sif"));
+		c.loadObservations(TEST_DATA_PATH("StudentData.txt"),TEST_DATA_PATH("controlStudent.json"));
+		c.trainNetwork();
+	}
+
+	Matrix<int> firstSample(unsigned int copies) const
+	{
+		const ObservationCodes& obs = c.getObservations();
+		Matrix<int> samples(copies, obs.getRowCount(), 0);
+		for(unsigned int col = 0; col < copies; col++) {
+			for(unsigned int row = 0; row < obs.getRowCount(); row++) {
+				samples.setData(obs(0, row), col, row);
+			}
+		}
+		return samples;
+	}
+
+	NetworkController c;
+};
+
+TEST_F(NetworkControllerSamplesTest, addSamplesKeepsFrequencies){
+	Network trained = c.getNetwork();
+	c.addSamples(c.getObservations());
+	expectSameParameters(trained, c.getNetwork(), 1e-6f);
+	for(unsigned int i = 0; i < trained.size(); i++) {
+		const Table<int>& before = trained.getNode(i).getObservationMatrix();
+		const Table<int>& after = c.getNetwork().getNode(i).getObservationMatrix();
+		for(unsigned int row = 0; row < before.getRowCount(); row++) {
+			for(unsigned int col = 0; col < before.getColCount(); col++) {
+				ASSERT_EQ(2 * before(col, row), after(col, row));
+			}
+		}
+	}
+}
+
+TEST_F(NetworkControllerSamplesTest, forgetting){
+	c.setForgettingFactor(0.5);
+	c.addSamples(firstSample(40));
+	const Node& intelligence = c.getNetwork().getNode("Intelligence");
+	int value = c.getObservations()(0, intelligence.getObservationRow());
+	ASSERT_NEAR(1.0f, intelligence.getProbability(value, 0), 1e-5);
+	ASSERT_NEAR(0.0f, intelligence.getProbability(1 - value, 0), 1e-5);
+}
+
+TEST_F(NetworkControllerSamplesTest, addSamplesWithoutForgetting){
+	const Node& intelligence = c.getNetwork().getNode("Intelligence");
+	int value = c.getObservations()(0, intelligence.getObservationRow());
+	int count = intelligence.getObservationMatrix()(value, 0);
+	int total = intelligence.getObservationMatrix().calculateRowSum(0);
+	c.addSamples(firstSample(10));
+	ASSERT_NEAR(float(count + 10) / (total + 10),
+	            intelligence.getProbability(value, 0), 1e-6);
+}
+
+TEST_F(NetworkControllerSamplesTest, invalidSamples){
+	Matrix<int> samples = firstSample(2);
+	samples.setData(42, 1, 0);
+	Network trained = c.getNetwork();
+	ASSERT_THROW(c.addSamples(samples), std::invalid_argument);
+	ASSERT_EQ(trained.getNode(0).getObservationMatrix()(0, 0),
+	          c.getNetwork().getNode(0).getObservationMatrix()(0, 0));
+	ASSERT_THROW(c.addSamples(Matrix<int>(1, 1, 0)), std::invalid_argument);
+	ASSERT_THROW(c.setForgettingFactor(0.0), std::invalid_argument);
+	ASSERT_THROW(c.setForgettingFactor(1.5), std::invalid_argument);
+}
+
+TEST_F(NetworkControllerTest, trainNetworkFromFile){
+	NetworkController inMemory;
+	inMemory.loadNetwork(TEST_DATA_PATH("Student.na"));
+	inMemory.loadNetwork(TEST_DATA_PATH("Student.sif"));
+	inMemory.loadObservations(TEST_DATA_PATH("dataStudent60.txt"),TEST_DATA_PATH("controlStudent.json"));
+	inMemory.trainNetwork();
+
+	NetworkController streamed;
+	streamed.loadNetwork(TEST_DATA_PATH("Student.na"));
+	streamed.loadNetwork(TEST_DATA_PATH("Student.sif"));
+	streamed.trainNetworkFromFile(TEST_DATA_PATH("dataStudent60.txt"),TEST_DATA_PATH("controlStudent.json"), 7);
+
+	ASSERT_NEAR(inMemory.getLikelihoodOfTheData(), streamed.getLikelihoodOfTheData(), 1e-4);
+	ASSERT_EQ(0u, streamed.getObservations().getColCount());
+	ASSERT_EQ(inMemory.getObservations().getRowCount(), streamed.getObservations().getRowCount());
+	for(const Node& expected : inMemory.getNetwork().getNodes()) {
+		const Node& n = streamed.getNetwork().getNode(expected.getName());
+		ASSERT_EQ(expected.getValueNames(), n.getValueNames());
+		const Table<int>& counts = expected.getObservationMatrix();
+		for(unsigned int row = 0; row < counts.getRowCount(); row++) {
+			for(unsigned int col = 0; col < counts.getColCount(); col++) {
+				ASSERT_EQ(counts(col, row), n.getObservationMatrix()(col, row));
+			}
+		}
+	}
+	expectSameParameters(inMemory.getNetwork(), streamed.getNetwork(), 1e-3f);
+}
+
+TEST_F(NetworkControllerTest, trainNetworkFromFileInvalid){
+	NetworkController n;
+	n.loadNetwork(TEST_DATA_PATH("Student.na"));
+	n.loadNetwork(TEST_DATA_PATH("Student.sif"));
+	ASSERT_THROW(n.trainNetworkFromFile(TEST_DATA_PATH("StudentData.txt"),TEST_DATA_PATH("controlStudent.json"), 0), std::invalid_argument);
+	ASSERT_THROW(n.trainNetworkFromFile(TEST_DATA_PATH("unkownfile.txt"),TEST_DATA_PATH("controlStudent.json")), std::invalid_argument);
+}
@@ -0,0 +1,88 @@
+#include "gtest/gtest.h"
+#include "../core/NetworkGenerator.h"
+#include "../core/NetworkController.h"
+
+#include <cstdio>
+
+class NetworkGeneratorTest : public ::testing::Test{
+	protected:
+	NetworkGeneratorTest()
+	{
+		settings_.nodes = 50;
+		settings_.maxParents = 3;
+		settings_.minCardinality = 2;
+		settings_.maxCardinality = 4;
+		settings_.treewidth = 5;
+	}
+
+	public:
+	GeneratorSettings settings_;
+};
+
+TEST_F(NetworkGeneratorTest, structure){
+	NetworkGenerator g(settings_);
+	const Network& n = g.getNetwork();
+	ASSERT_EQ(50, n.size());
+	ASSERT_FALSE(n.checkCycleExistence());
+	for(const auto& node : n.getNodes()){
+		ASSERT_LE(node.getParents().size(), 3u);
+		for(auto parent : node.getParents()){
+			ASSERT_LT(parent, node.getID());
+			ASSERT_LE(node.getID() - parent, 5u);
+		}
+		ASSERT_GE(g.getCardinality(node.getID()), 2u);
+		ASSERT_LE(g.getCardinality(node.getID()), 4u);
+		const auto& cpt = g.getProbabilities(node.getID());
+		ASSERT_EQ(g.getCardinality(node.getID()), cpt.getColCount());
+		for(unsigned int row = 0; row < cpt.getRowCount(); row++){
+			ASSERT_NEAR(1.0f, cpt.calculateRowSum(row), 1e-5);
+		}
+	}
+}
+
+TEST_F(NetworkGeneratorTest, reproducible){
+	NetworkGenerator g1(settings_);
+	NetworkGenerator g2(settings_);
+	for(unsigned int id = 0; id < settings_.nodes; id++){
+		ASSERT_EQ(g1.getNetwork().getNode(id).getParents(),
+		          g2.getNetwork().getNode(id).getParents());
+	}
+	const auto s1 = g1.sample(100);
+	const auto s2 = g2.sample(100);
+	ASSERT_TRUE(std::equal(s1.getData(), s1.getData() + 100 * settings_.nodes, s2.getData()));
+	for(unsigned int id = 0; id < settings_.nodes; id++){
+		for(unsigned int sample = 0; sample < 100; sample++){
+			ASSERT_LT(s1(sample, id), g1.getCardinality(id));
+		}
+	}
+}
+
+TEST_F(NetworkGeneratorTest, invalidSettings){
+	settings_.minCardinality = 5;
+	ASSERT_THROW(NetworkGenerator g(settings_), std::invalid_argument);
+	settings_.minCardinality = 1;
+	ASSERT_THROW(NetworkGenerator g(settings_), std::invalid_argument);
+}
+
+TEST_F(NetworkGeneratorTest, filesCanBeTrained){
+	NetworkGenerator g(settings_);
+	const std::string prefix = "generatedNetworkTest";
+	g.writeNetwork(prefix + ".tgf");
+	g.writeObservations(prefix + ".txt", 200, 0.1f);
+	g.writeDiscretisation(prefix + ".json");
+
+	NetworkController c;
+	c.loadNetwork(prefix + ".tgf");
+	c.loadObservations(prefix + ".txt", prefix + ".json");
+	c.trainNetwork();
+	ASSERT_EQ(50, c.getNetwork().size());
+	for(unsigned int id = 0; id < settings_.nodes; id++){
+		ASSERT_EQ(g.getNetwork().getNode(id).getParents(),
+		          c.getNetwork().getNode(id).getParents());
+	}
+
+	std::remove((prefix + ".tgf").c_str());
+	std::remove((prefix + ".txt").c_str());
+	std::remove((prefix + ".json").c_str());
+	std::remove("discretisedData.txt");
+}
@@ -2,6 +2,8 @@
 #include "../core/Network.h"
 #include "config.h"
 
+#include <algorithm>
+
 class NetworkTest : public ::testing::Test{
 	protected:
 	NetworkTest()
@@ -21,6 +23,30 @@ TEST_F(NetworkTest, readNetworkNASIF){
 	ASSERT_THROW(n_.getNode("Test"),std::invalid_argument);
 }
 
+TEST_F(NetworkTest, readNetworkSIFMultipleTargets){
+	n_.readNetwork(TEST_DATA_PATH("Student.na"));
+	n_.readNetwork(TEST_DATA_PATH("StudentMultiTarget.sif"));
+	std::vector<unsigned int> gradeParents = {0, 2};
+	ASSERT_EQ(gradeParents, n_.getNode("Grade").getParents());
+	std::vector<unsigned int> satParents = {2};
+	ASSERT_EQ(satParents, n_.getNode("SAT").getParents());
+	ASSERT_EQ(1, n_.getNode("Letter").getParents().size());
+}
+
+TEST_F(NetworkTest, readNetworkDot){
+	n_.readNetwork(TEST_DATA_PATH("Student.dot"));
+	ASSERT_EQ(5, n_.size());
+	ASSERT_EQ("Difficulty", n_.getNode(0).getName());
+	std::vector<unsigned int> gradeParents = {n_.getIndex("Difficulty"),
+	                                          n_.getIndex("Intelligence")};
+	std::sort(gradeParents.begin(), gradeParents.end());
+	ASSERT_EQ(gradeParents, n_.getNode("Grade").getParents());
+	std::vector<unsigned int> letterParents = {n_.getIndex("Grade")};
+	ASSERT_EQ(letterParents, n_.getNode("Letter").getParents());
+	ASSERT_TRUE(n_.getNode("Difficulty").getParents().empty());
+	ASSERT_THROW(n_.readNetwork(TEST_DATA_PATH("simpleGraph.dot")), std::invalid_argument);
+}
+
 TEST_F(NetworkTest, readCyclicNetwork){
 	ASSERT_THROW(n_.readNetwork(TEST_DATA_PATH("cylicNetwork1.tgf")),std::invalid_argument);
 	ASSERT_THROW(n_.readNetwork(TEST_DATA_PATH("cylicNetwork2.tgf")),std::invalid_argument);
@@ -100,3 +126,34 @@ TEST_F(NetworkTest, cycle){
 	n_.readNetwork(TEST_DATA_PATH("test.tgf"));
 	ASSERT_FALSE(n_.checkCycleExistence(1));
 }
+
+TEST_F(NetworkTest, cycleWholeNetwork){
+	n_.readNetwork(TEST_DATA_PATH("test.tgf"));
+	ASSERT_FALSE(n_.checkCycleExistence());
+	n_.addEdge(0,2);
+	ASSERT_TRUE(n_.checkCycleExistence());
+}
+
+TEST_F(NetworkTest, edgeInducesCycle){
+	n_.readNetwork(TEST_DATA_PATH("test.tgf"));
+	ASSERT_TRUE(n_.edgeInducesCycle(0,2));
+	ASSERT_TRUE(n_.edgeInducesCycle(1,1));
+	ASSERT_FALSE(n_.edgeInducesCycle(2,0));
+	ASSERT_TRUE(n_.isAncestor(0,2));
+	ASSERT_FALSE(n_.isAncestor(2,0));
+}
+
+TEST_F(NetworkTest, topologicalOrder){
+	n_.readNetwork(TEST_DATA_PATH("test.tgf"));
+	std::vector<unsigned int> expected = {0, 1, 2};
+	ASSERT_EQ(expected, n_.getTopologicalOrder());
+	ASSERT_EQ(0, n_.getDepth(0));
+	ASSERT_EQ(2, n_.getDepth(2));
+	ASSERT_TRUE(n_.getAncestors(2)[0]);
+	ASSERT_TRUE(n_.getAncestors(2)[1]);
+	ASSERT_FALSE(n_.getAncestors(0)[2]);
+	n_.removeEdge(2, 1);
+	ASSERT_EQ(0, n_.getDepth(2));
+	ASSERT_TRUE(n_.getAncestors(2).none());
+	ASSERT_FALSE(n_.isAncestor(0, 2));
+}
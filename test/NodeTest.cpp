@@ -6,14 +6,14 @@ class NodeTest : public ::testing::Test{
 	NodeTest()
 		:n_(Node(0,1,"TestNode"))
 	{
-		n_.setProbability(Matrix<float>(3,3,0.5f));
-		n_.setObservations(Matrix<int>(3,3,42));
+		n_.setProbability(Table<float>(3,3,0.5f));
+		n_.setObservations(Table<int>(3,3,42));
 		n_.setParents({1,2});
 		n_.setUniqueValues({1,2,3,4});
 		n_.setUniqueValuesExcludingNA({1,2,3,4});
 		n_.setValueNames({"A","B","C","D"});
 		n_.setValueNamesProb({"A","B","C","D"});
-		n_.setParentValueNames({"A","B","C","D"});
+		n_.setParentValueNameLists({{"A"},{"X","Y","Z"}});
 		n_.setObservationRow(42);
 	}
 	public:
@@ -102,6 +102,34 @@ TEST_F(NodeTest, valueNamesProb){
 	ASSERT_TRUE(n_.getValueNamesProb()==valueNamesProb);
 }
 
+TEST_F(NodeTest, parentValueNames){
+	std::vector<std::string> parentValueNames {"A,X","A,Y","A,Z"};
+	ASSERT_EQ(3u, n_.getNumberOfParentValues());
+	ASSERT_TRUE(n_.getParentValueNames()==parentValueNames);
+	ASSERT_EQ("A,Y", n_.getParentValueName(1));
+}
+
+TEST_F(NodeTest, probabilityByNames){
+	n_.setProbability(0.25f,"B","A,Z");
+	ASSERT_TRUE(0.25f==n_.getProbability(1,2));
+	ASSERT_TRUE(0.25f==n_.getProbability("B","A,Z"));
+	ASSERT_THROW(n_.getProbability("B","A"), std::invalid_argument);
+	ASSERT_THROW(n_.getProbability("E","A,X"), std::invalid_argument);
+}
+
+TEST_F(NodeTest, probabilityByNamesWithCommas){
+	n_.setParentValueNameLists({{"A", "A,X"}, {"X", "X,Y", "Z"}});
+	n_.setProbability(Table<float>(4, 6, 0.5f));
+	n_.setProbability(0.25f, "B", "A,X,X,Y");
+	ASSERT_TRUE(0.25f == n_.getProbability(1, 4));
+	n_.setProbability(0.125f, "B", "A,X,Y");
+	ASSERT_TRUE(0.125f == n_.getProbability(1, 1));
+	n_.setProbability(0.75f, "C", "A,Z");
+	ASSERT_TRUE(0.75f == n_.getProbability(2, 2));
+	ASSERT_THROW(n_.getProbability("B", "A,X,"), std::invalid_argument);
+	ASSERT_THROW(n_.getProbability("B", "A,Y"), std::invalid_argument);
+}
+
 TEST_F(NodeTest, clearNames){
 	n_.clearNameVectors();
 	ASSERT_TRUE(n_.getValueNames().empty());
@@ -0,0 +1,79 @@
+#include "gtest/gtest.h"
+#include "../core/ObservationCodes.h"
+#include "config.h"
+
+#include <sstream>
+
+class ObservationCodesTest : public ::testing::Test{
+	protected:
+	ObservationCodesTest()
+	:m_(Matrix<int>(3,2,0)){
+	m_.setData(1,0,0);
+	m_.setData(-1,1,0);
+	m_.setData(1,2,0);
+	m_.setData(2,0,1);
+	m_.setRowNames({"A","B"});
+	m_.setColNames({"s1","s2","s3"});
+	}
+	public:
+	Matrix<int> m_;
+
+};
+
+TEST_F(ObservationCodesTest,Conversion){
+	ObservationCodes codes(m_);
+	ASSERT_EQ(3u,codes.getColCount());
+	ASSERT_EQ(2u,codes.getRowCount());
+	ASSERT_EQ(1u,codes.getWidth());
+	ASSERT_EQ(1,codes(0,0));
+	ASSERT_EQ(-1,codes(1,0));
+	ASSERT_EQ(0,codes(1,1));
+	ASSERT_EQ(ObservationCodes::NA,codes.getRow<std::uint8_t>(0)[1]);
+	ASSERT_EQ(1,codes.findRow("B"));
+	ASSERT_EQ(-1,codes.findRow("C"));
+	Matrix<int> back = codes.toMatrix();
+	for(unsigned int row = 0; row < 2; row++) {
+		for(unsigned int col = 0; col < 3; col++) {
+			ASSERT_EQ(m_(col,row),back(col,row));
+		}
+	}
+}
+
+TEST_F(ObservationCodesTest,UniqueValues){
+	ObservationCodes codes(m_);
+	ASSERT_EQ(std::vector<int>({-1,1}),codes.getUniqueRowValues(0));
+	ASSERT_EQ(std::vector<int>({1}),codes.getUniqueRowValues(0,-1));
+	ASSERT_EQ(std::vector<int>({0,2}),codes.getUniqueRowValues(1));
+}
+
+TEST_F(ObservationCodesTest,Width){
+	ASSERT_EQ(1u,ObservationCodes::getWidthFor(254));
+	ASSERT_EQ(2u,ObservationCodes::getWidthFor(255));
+	ASSERT_EQ(2u,ObservationCodes::getWidthFor(65534));
+	ASSERT_EQ(4u,ObservationCodes::getWidthFor(65535));
+	m_.setData(300,2,1);
+	ObservationCodes codes(m_);
+	ASSERT_EQ(2u,codes.getWidth());
+	ASSERT_EQ(300,codes(2,1));
+	ASSERT_EQ(-1,codes(1,0));
+}
+
+TEST_F(ObservationCodesTest,SetData){
+	ObservationCodes codes(2,{"A"},3);
+	ASSERT_EQ(-1,codes(0,0));
+	codes.setData(3,1,0);
+	ASSERT_EQ(3,codes(1,0));
+	ASSERT_THROW(codes.setData(255,0,0),std::invalid_argument);
+	ASSERT_THROW(codes.setData(-2,0,0),std::invalid_argument);
+	ASSERT_THROW(codes.setData(0,2,0),std::invalid_argument);
+	m_.setData(-2,0,0);
+	ASSERT_THROW(ObservationCodes codes2(m_),std::invalid_argument);
+}
+
+TEST_F(ObservationCodesTest,Output){
+	std::stringstream codes;
+	codes << ObservationCodes(m_);
+	std::stringstream matrix;
+	matrix << m_;
+	ASSERT_EQ(matrix.str(),codes.str());
+}
@@ -0,0 +1,148 @@
+#include "gtest/gtest.h"
+#include "../core/Discretiser.h"
+#include "../core/ObservationStream.h"
+#include "config.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <random>
+
+namespace
+{
+// Heap usage of the test, recorded by the replaced operators new and delete
+std::atomic<size_t> allocatedBytes(0);
+std::atomic<size_t> peakBytes(0);
+
+// Keeps the size of every allocation in front of it, such that delete can
+// account for it
+constexpr size_t headerSize = alignof(std::max_align_t);
+
+void* allocate(size_t size)
+{
+	char* memory = static_cast<char*>(std::malloc(size + headerSize));
+	if(!memory) {
+		throw std::bad_alloc();
+	}
+	*reinterpret_cast<size_t*>(memory) = size;
+	const size_t current = allocatedBytes += size;
+	size_t peak = peakBytes;
+	while(current > peak && !peakBytes.compare_exchange_weak(peak, current)) {
+	}
+	return memory + headerSize;
+}
+
+void deallocate(void* pointer)
+{
+	if(!pointer) {
+		return;
+	}
+	char* memory = static_cast<char*>(pointer) - headerSize;
+	allocatedBytes -= *reinterpret_cast<size_t*>(memory);
+	std::free(memory);
+}
+}
+
+void* operator new(size_t size) { return allocate(size); }
+void* operator new[](size_t size) { return allocate(size); }
+void operator delete(void* pointer) noexcept { deallocate(pointer); }
+void operator delete[](void* pointer) noexcept { deallocate(pointer); }
+void operator delete(void* pointer, size_t) noexcept { deallocate(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { deallocate(pointer); }
+
+class ObservationStreamTest : public ::testing::Test{
+	protected:
+	ObservationStreamTest()
+	    : settings_(TEST_DATA_PATH("jsonDiscretiserTest.json"))
+	{
+	}
+
+	// Writes a file with numeric rows for the quantile and moment based
+	// methods and categorical rows for the methods numbering the values
+	std::string writeSamples(unsigned int samples) const
+	{
+		const std::string filename =
+		    testing::TempDir() + "observationStream" +
+		    std::to_string(samples) + ".txt";
+		std::ofstream file(filename);
+		std::mt19937 generator(42);
+		std::normal_distribution<float> normal(5.0f, 2.0f);
+		for(const char* row : {"Median", "BracketMedians", "PersonTukey",
+		                       "AMean", "Z", "Round", "mapNamesToInt"}) {
+			file << row;
+			const std::string name(row);
+			for(unsigned int col = 0; col < samples; col++) {
+				file << '\t';
+				if(col % 17 == 0) {
+					file << "NA";
+				} else if(name == "mapNamesToInt") {
+					file << (col % 3 == 0 ? "Up" : "Down");
+				} else if(name == "Round") {
+					file << col % 5 + 0.25f;
+				} else {
+					file << normal(generator);
+				}
+			}
+			file << '\n';
+		}
+		return filename;
+	}
+
+	// Peak heap usage while the file is streamed
+	size_t measureStreaming(const std::string& filename) const
+	{
+		Network network;
+		peakBytes = allocatedBytes.load();
+		const size_t before = allocatedBytes;
+		ObservationStream stream(filename, settings_, network);
+		return peakBytes - before;
+	}
+
+	DiscretisationSettings settings_;
+};
+
+TEST_F(ObservationStreamTest, sameAsDiscretiser){
+	for(const char* file : {"testObservations.txt", "testObservationsIncludingNA.txt"}) {
+		SCOPED_TRACE(file);
+		Matrix<std::string> original(TEST_DATA_PATH("") + std::string(file), false, true);
+		Matrix<int> expected;
+		Network inMemory;
+		Discretiser discretiser(original, expected, inMemory);
+		discretiser.setJsonTree(settings_);
+		discretiser.discretise();
+
+		Network streamed;
+		ObservationStream stream(TEST_DATA_PATH("") + std::string(file), settings_, streamed);
+		ASSERT_EQ(expected.getColCount(), stream.getSampleCount());
+		ASSERT_EQ(expected.getRowNames(), stream.getRowNames());
+		ObservationCodes codes;
+		stream.readSamples(0, stream.getSampleCount(), codes);
+		for(unsigned int row = 0; row < expected.getRowCount(); row++) {
+			SCOPED_TRACE(expected.getRowNames()[row]);
+			for(unsigned int col = 0; col < expected.getColCount(); col++) {
+				ASSERT_EQ(expected(col, row), codes(col, row));
+			}
+		}
+		ASSERT_EQ(inMemory.getObservationsMap(), streamed.getObservationsMap());
+		ASSERT_EQ(inMemory.getObservationsMapR(), streamed.getObservationsMapR());
+	}
+}
+
+TEST_F(ObservationStreamTest, boundedMemory){
+	const std::string smallFile = writeSamples(100000);
+	const std::string largeFile = writeSamples(400000);
+	const size_t small = measureStreaming(smallFile);
+	const size_t large = measureStreaming(largeFile);
+	std::remove(smallFile.c_str());
+	std::remove(largeFile.c_str());
+	// Holding the raw values of a single row of the large file would take
+	// more than ten megabytes
+	ASSERT_LT(large, 1u << 20);
+	ASSERT_LT(large, small + small / 4);
+}
+
+TEST_F(ObservationStreamTest, invalidFile){
+	Network network;
+	ASSERT_THROW(ObservationStream(TEST_DATA_PATH("unknownFile.txt"), settings_, network), std::invalid_argument);
+}
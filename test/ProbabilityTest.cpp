@@ -3,6 +3,8 @@
 #include "../core/NetworkController.h"
 #include "config.h"
 
+#include <algorithm>
+
 class ProbabilityTest : public ::testing::Test{
 	protected:
 	ProbabilityTest()
@@ -153,6 +155,32 @@ TEST_F(ProbabilityTest, ConditionalProbability){
 }
 
 
+TEST_F(ProbabilityTest, ConditionalProbabilityIrrelevantEvidence){
+	Network n = c.getNetwork();
+	ProbabilityHandler p (n);
+	unsigned int letter = n.getNode("Letter").getID();
+	unsigned int grade = n.getNode("Grade").getID();
+	unsigned int sat = n.getNode("SAT").getID();
+	std::vector<int> mn(5,-1);
+	mn[letter]=0;
+	std::vector<int> md(5,-1);
+	md[grade]=1;
+	float expected = p.computeConditionalProbability({letter}, {grade}, mn, md);
+	//SAT is d-separated from Letter given Grade
+	md[sat]=1;
+	ASSERT_NEAR(expected, p.computeConditionalProbability({letter}, {grade, sat}, mn, md), 0.0001);
+	md[sat]=0;
+	ASSERT_NEAR(expected, p.computeConditionalProbability({letter}, {grade, sat}, mn, md), 0.0001);
+	//Only the CPT of Letter is needed, SAT and the parents of Grade are pruned
+	std::vector<unsigned int> required = p.getRequiredNodes({letter}, {grade, sat}, md);
+	ASSERT_EQ(std::vector<unsigned int>{letter}, required);
+	//Without evidence on Grade, SAT is informative about Letter and is kept
+	md[grade]=-1;
+	required = p.getRequiredNodes({letter}, {sat}, md);
+	ASSERT_TRUE(std::find(required.begin(), required.end(), grade) != required.end());
+	ASSERT_TRUE(std::find(required.begin(), required.end(), sat) != required.end());
+}
+
 TEST_F(ProbabilityTest, maxSearch){
 	Network n = c.getNetwork();
 	ProbabilityHandler p (n);
@@ -0,0 +1,40 @@
+#include "gtest/gtest.h"
+#include "../core/QuantileSketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+TEST(QuantileSketchTest, exactBelowCapacity){
+	QuantileSketch sketch(16);
+	for(float value : {5.0f, 1.0f, 4.0f, 2.0f, 3.0f}) {
+		sketch.add(value);
+	}
+	ASSERT_TRUE(sketch.isExact());
+	ASSERT_EQ(5u, sketch.size());
+	std::vector<float> result = sketch.select({0, 2, 4, 5});
+	ASSERT_EQ(1.0f, result[0]);
+	ASSERT_EQ(3.0f, result[1]);
+	ASSERT_EQ(5.0f, result[2]);
+	ASSERT_TRUE(std::isnan(result[3]));
+}
+
+TEST(QuantileSketchTest, approximateRanks){
+	const unsigned int count = 100000;
+	std::vector<float> values(count);
+	std::iota(values.begin(), values.end(), 0.0f);
+	std::shuffle(values.begin(), values.end(), std::mt19937(42));
+	QuantileSketch sketch(256);
+	for(float value : values) {
+		sketch.add(value);
+	}
+	ASSERT_FALSE(sketch.isExact());
+	ASSERT_EQ(count, sketch.size());
+	// The values equal their ranks
+	const std::vector<size_t> ranks {0, count / 10, count / 2, count - 1};
+	const std::vector<float> result = sketch.select(ranks);
+	for(size_t i = 0; i < ranks.size(); i++) {
+		ASSERT_NEAR(ranks[i], result[i], 0.02 * count);
+	}
+}
@@ -0,0 +1,37 @@
+#include "gtest/gtest.h"
+#include "../core/QueryArena.h"
+
+class QueryArenaTest : public ::testing::Test{
+	protected:
+	QueryArenaTest()
+		:arena_(1024)
+	{
+	}
+
+	public:
+	QueryArena arena_;
+};
+
+TEST_F(QueryArenaTest, allocatesFromBuffer){
+	{
+		QueryArenaGuard guard(arena_);
+		std::pmr::vector<float> v(100, 1.0f, arena_.resource());
+		ASSERT_EQ(100u, v.size());
+	}
+	ASSERT_EQ(1024u, arena_.getCapacity());
+}
+
+TEST_F(QueryArenaTest, growsAfterOverflow){
+	{
+		QueryArenaGuard guard(arena_);
+		std::pmr::vector<float> v(1000, 1.0f, arena_.resource());
+		ASSERT_EQ(1.0f, v[999]);
+	}
+	size_t capacity = arena_.getCapacity();
+	ASSERT_GE(capacity, 1024u + 1000 * sizeof(float));
+	{
+		QueryArenaGuard guard(arena_);
+		std::pmr::vector<float> v(1000, 1.0f, arena_.resource());
+	}
+	ASSERT_EQ(capacity, arena_.getCapacity());
+}
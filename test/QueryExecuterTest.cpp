@@ -156,3 +156,23 @@ TEST_F(QueryExecuterTest, QECheck21){
 	qe.setCondition(0,0);	
 	ASSERT_NEAR(0.48f, qe.execute().first, 0.001);	
 }
+
+TEST_F(QueryExecuterTest, Profiling){
+	QueryExecuter qe (c);
+	qe.setNonIntervention(1,0);
+	qe.setCondition(0,0);
+	QueryStats stats;
+	stats.eliminations = 42;
+	float expected = QueryExecuter(qe).execute().first;
+	ASSERT_FLOAT_EQ(expected, qe.execute(stats).first);
+	EXPECT_GT(stats.totalTime.count(), 0);
+	if(Profiling::enabled) {
+		EXPECT_GT(stats.factorsCreated, 0u);
+		EXPECT_GT(stats.eliminations, 0u);
+		EXPECT_GT(stats.maxFactorSize, 0u);
+		EXPECT_FALSE(c.getEMIterationStats().empty());
+	} else {
+		EXPECT_EQ(0u, stats.eliminations);
+	}
+	EXPECT_EQ(nullptr, Profiling::activeStats());
+}
@@ -0,0 +1,95 @@
+#include "gtest/gtest.h"
+#include "../core/NetworkController.h"
+#include "../core/Trace.h"
+#include "config.h"
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
+
+class TraceTest : public ::testing::Test{
+	protected:
+	~TraceTest() { Trace::disable(); }
+
+	static bool contains(const std::vector<Trace::Event>& events,
+	                     const std::string& name)
+	{
+		return std::any_of(events.begin(), events.end(),
+		                   [&name](const Trace::Event& e) {
+			                   return name == e.name;
+			               });
+	}
+};
+
+TEST_F(TraceTest, disabledRecordsNothing){
+	Trace::enable();
+	Trace::disable();
+	{
+		CT_TRACE_SCOPE("ignored");
+	}
+	ASSERT_TRUE(Trace::getEvents().empty());
+}
+
+TEST_F(TraceTest, nestedEvents){
+	Trace::enable();
+	{
+		CT_TRACE_SCOPE("outer");
+		{
+			CT_TRACE_SCOPE("inner");
+		}
+	}
+	Trace::disable();
+	auto events = Trace::getEvents();
+	ASSERT_EQ(2u, events.size());
+	// Events are recorded when they end
+	EXPECT_STREQ("inner", events[0].name);
+	EXPECT_STREQ("outer", events[1].name);
+	EXPECT_LE(events[1].start, events[0].start);
+	EXPECT_GE(events[1].start + events[1].duration,
+	          events[0].start + events[0].duration);
+	EXPECT_EQ(events[0].thread, events[1].thread);
+}
+
+TEST_F(TraceTest, threadsAreDistinguished){
+	Trace::enable();
+	{
+		CT_TRACE_SCOPE("main");
+	}
+	std::thread worker([]() { CT_TRACE_SCOPE("worker"); });
+	worker.join();
+	Trace::disable();
+	auto events = Trace::getEvents();
+	ASSERT_EQ(2u, events.size());
+	EXPECT_NE(events[0].thread, events[1].thread);
+}
+
+TEST_F(TraceTest, writeChromeTrace){
+	Trace::enable();
+	{
+		CT_TRACE_SCOPE("quote\"d");
+	}
+	Trace::disable();
+	std::stringstream ss;
+	Trace::write(ss);
+	const std::string json = ss.str();
+	EXPECT_EQ(0u, json.find("{\"traceEvents\":["));
+	EXPECT_NE(std::string::npos, json.find("\"name\":\"quote\\\"d\""));
+	EXPECT_NE(std::string::npos, json.find("\"ph\":\"X\""));
+	EXPECT_NE(std::string::npos, json.find("\"dur\":"));
+}
+
+TEST_F(TraceTest, trainingAndQueries){
+	NetworkController c;
+	Trace::enable();
+	c.loadNetwork(TEST_DATA_PATH("Student.na"));
+	c.loadNetwork(TEST_DATA_PATH("Student.sif"));
+	c.loadObservations(TEST_DATA_PATH("StudentData.txt"),
+	                   TEST_DATA_PATH("controlStudent.json"));
+	c.trainNetwork();
+	Trace::disable();
+	auto events = Trace::getEvents();
+	EXPECT_TRUE(contains(events, "NetworkController::loadObservations"));
+	EXPECT_TRUE(contains(events, "Discretiser::discretise"));
+	EXPECT_TRUE(contains(events, "DataDistribution::distributeObservations"));
+	EXPECT_TRUE(contains(events, "EM::mPhase"));
+}